@@ -0,0 +1,94 @@
+// Parameter sweep throughput: the same ticks through N scalar contexts and
+// through one batch of N lanes per SIMD kernel.
+//
+//   batch_lanes [lanes [ticks]]
+//
+// Defaults: 512 lanes (sar_step/sar_max/base_sl spread over a grid), 50000
+// synthetic ticks. Reports ns per lane-tick; kernels the CPU lacks are skipped.
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "ea_api.h"
+#include "feeds.h"
+
+namespace {
+
+void synth(std::vector<int64_t>& t, std::vector<double>& bid, std::vector<double>& ask, int32_t n){
+    ea::tools::Walk w{12345, 60000.0};
+    for(int32_t i=0;i<n;++i){
+        const double px = w.step();
+        t.push_back(1700000000 + i/40); bid.push_back(px); ask.push_back(px + 0.20);
+    }
+}
+
+void lane_params(int32_t i, double& step, double& amax, double& base_sl){
+    step = 0.0005*(1 + i%8);
+    amax = 0.05*(1 + (i/8)%8);
+    base_sl = 2000.0 + 1000.0*(i/64);
+}
+
+double seconds_since(std::chrono::steady_clock::time_point t0){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}
+
+int main(int argc, char** argv){
+    const int32_t lanes = argc>1 ? std::atoi(argv[1]) : 512;
+    const int32_t n = argc>2 ? std::atoi(argv[2]) : 50000;
+    if(lanes<1 || lanes>4096 || n<1){ std::fprintf(stderr, "bad arguments\n"); return 1; }
+    std::vector<int64_t> t; std::vector<double> bid, ask;
+    synth(t, bid, ask, n);
+    const double work = (double)lanes*n;
+    std::printf("%d lanes x %d ticks\n\n%-10s %10s %14s %9s %10s\n", lanes, n, "engine", "wall ms", "ns/lane-tick", "speedup", "plans");
+
+    // N contexts, one EA_OnTick each per tick
+    double ctx_ns = 0;
+    {
+        std::vector<int32_t> h(lanes);
+        for(int32_t i=0;i<lanes;++i){
+            double step, amax, base_sl;
+            lane_params(i, step, amax, base_sl);
+            h[i] = EA_CreateContext();
+            EA_Init(h[i], "BTCUSD", 1, 2, 0.01);
+            EA_SetParamDouble(h[i], "sar_step", step);
+            EA_SetParamDouble(h[i], "sar_max", amax);
+            EA_SetParamDouble(h[i], "base_sl_points", base_sl);
+        }
+        int64_t plans = 0;
+        const auto t0 = std::chrono::steady_clock::now();
+        for(int32_t k=0;k<n;++k)
+            for(int32_t i=0;i<lanes;++i){
+                int32_t a = 0;
+                EA_OnTick(h[i], bid[k], ask[k], t[k], 0, &a);
+                plans += a==EA_PLAN_ORDERS;
+            }
+        const double s = seconds_since(t0);
+        ctx_ns = s*1e9/work;
+        std::printf("%-10s %10.1f %14.2f %9s %10lld\n", "contexts", s*1e3, ctx_ns, "1.00x", (long long)plans);
+        for(int32_t x : h) EA_DestroyContext(x);
+    }
+
+    static const char* const kIsa[] = { "scalar", "avx2", "avx512" };
+    for(int32_t isa=EA_ISA_SCALAR; isa<=EA_ISA_AVX512; ++isa){
+        const int32_t b = EA_BatchCreate(lanes, 2, 0.01, isa);
+        if(b<=0){ std::fprintf(stderr, "EA_BatchCreate failed\n"); return 1; }
+        if(EA_BatchIsa(b)!=isa){ std::printf("%-10s %10s\n", kIsa[isa], "n/a"); EA_BatchDestroy(b); continue; }
+        for(int32_t i=0;i<lanes;++i){
+            double step, amax, base_sl;
+            lane_params(i, step, amax, base_sl);
+            EA_BatchSetParam(b, i, "sar_step", step);
+            EA_BatchSetParam(b, i, "sar_max", amax);
+            EA_BatchSetParam(b, i, "base_sl_points", base_sl);
+        }
+        const auto t0 = std::chrono::steady_clock::now();
+        const int32_t plans = EA_BatchRun(b, t.data(), bid.data(), ask.data(), n);
+        const double s = seconds_since(t0);
+        const double ns = s*1e9/work;
+        std::printf("%-10s %10.1f %14.2f %8.2fx %10d\n", kIsa[isa], s*1e3, ns, ctx_ns/ns, plans);
+        EA_BatchDestroy(b);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+// Load test for the sharded engine: many synthetic symbols, one context each,
+// fed through EA_ShardSubmitTick by as many producer threads as workers.
+//
+//   shard_load [symbols [ticks_per_symbol [max_workers]]]
+//
+// Defaults: 512 symbols, 2000 ticks each, workers 1..hardware threads. The
+// "direct" row is the same interleaved stream through EA_OnTick on one thread;
+// scaling is against one worker. It needs free cores: producers and workers
+// share the machine.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "ea_api.h"
+#include "feeds.h"
+
+namespace {
+
+struct Tick { int64_t t; double bid, ask; };
+
+// Per-symbol walk at 40 ticks per second, like tick_profile's synth.
+void synth(std::vector<Tick>& ticks, int32_t n, uint32_t seed){
+    ea::tools::Walk w{seed, 1000.0 + seed%50000};
+    ticks.resize((size_t)n);
+    for(int32_t i=0;i<n;++i){
+        const double px = w.step();
+        ticks[i] = { 1700000000 + i/40, px, px + 0.20 };
+    }
+}
+
+std::vector<int32_t> make(int32_t symbols){
+    std::vector<int32_t> hs((size_t)symbols);
+    for(int32_t k=0;k<symbols;++k){
+        char sym[16];
+        std::snprintf(sym, sizeof(sym), "SYN%04d", k);
+        hs[k] = EA_CreateContext();
+        EA_Init(hs[k], sym, 1, 2, 0.01);
+    }
+    return hs;
+}
+
+void destroy(const std::vector<int32_t>& hs){ for(int32_t h : hs) EA_DestroyContext(h); }
+
+double seconds_since(std::chrono::steady_clock::time_point t0){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}
+
+int main(int argc, char** argv){
+    const int32_t symbols = argc>1 ? std::atoi(argv[1]) : 512;
+    const int32_t per_sym = argc>2 ? std::atoi(argv[2]) : 2000;
+    const int32_t hw = std::max(1, (int32_t)std::thread::hardware_concurrency());
+    const int32_t max_workers = argc>3 ? std::atoi(argv[3]) : hw;
+    if(symbols<=0 || per_sym<=0 || max_workers<=0){ std::fprintf(stderr, "bad arguments\n"); return 1; }
+
+    std::vector<std::vector<Tick>> ticks((size_t)symbols);
+    for(int32_t k=0;k<symbols;++k) synth(ticks[k], per_sym, 12345u + 7919u*(uint32_t)k);
+    const double total = (double)symbols*per_sym;
+    std::printf("%d symbols x %d ticks, %d hardware threads\n\n", symbols, per_sym, hw);
+    std::printf("%-8s %9s %10s %12s %8s %10s %9s\n",
+                "workers", "producers", "wall ms", "ticks/s", "scaling", "plans", "retries");
+
+    // Direct: one thread, no queues
+    double base = 0, one = 0;
+    {
+        const std::vector<int32_t> hs = make(symbols);
+        int64_t plans = 0;
+        const auto t0 = std::chrono::steady_clock::now();
+        for(int32_t i=0;i<per_sym;++i)
+            for(int32_t k=0;k<symbols;++k){
+                const Tick& tk = ticks[k][i];
+                int32_t action = 0;
+                EA_OnTick(hs[k], tk.bid, tk.ask, tk.t, 0, &action);
+                plans += action==EA_PLAN_ORDERS;
+            }
+        const double s = seconds_since(t0);
+        base = total/s;
+        std::printf("%-8s %9d %10.1f %12.0f %8s %10lld %9d\n", "direct", 1, s*1e3, base, "-", (long long)plans, 0);
+        destroy(hs);
+    }
+
+    for(int32_t w=1; w<=max_workers; w = w<max_workers ? std::min(max_workers, w*2) : max_workers+1){
+        const std::vector<int32_t> hs = make(symbols);
+        const int32_t producers = w;
+        if(EA_ShardStart(w, 1)!=w){ std::fprintf(stderr, "EA_ShardStart(%d) failed\n", w); return 1; }
+        std::vector<int64_t> retries((size_t)producers);
+        const auto t0 = std::chrono::steady_clock::now();
+        std::vector<std::thread> prod;
+        for(int32_t p=0;p<producers;++p) prod.emplace_back([&, p]{
+            int64_t r = 0;
+            for(int32_t i=0;i<per_sym;++i)
+                for(int32_t k=p;k<symbols;k+=producers){
+                    const Tick& tk = ticks[k][i];
+                    while(EA_ShardSubmitTick(hs[k], tk.bid, tk.ask, tk.t, 0)==0){ ++r; std::this_thread::yield(); }
+                }
+            retries[p] = r;
+        });
+        for(std::thread& t : prod) t.join();
+        EA_ShardStop();
+        const double s = seconds_since(t0);
+        int64_t plans = 0;
+        EA_ShardPlan plan;
+        while(EA_ShardPollPlan(&plan)==1) ++plans;
+        int64_t r = 0;
+        for(int64_t x : retries) r += x;
+        const double rate = total/s;
+        if(w==1) one = rate;
+        std::printf("%-8d %9d %10.1f %12.0f %7.2fx %10lld %9lld\n",
+                    w, producers, s*1e3, rate, rate/one, (long long)plans, (long long)r);
+        destroy(hs);
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+// Replays a tick file through EA_OnTick and prints where the cycles go.
+//
+//   tick_profile [ticks.csv [digits point [range_bar_points]]]
+//
+// CSV lines are "time,bid,ask" where time is epoch seconds or MT4's
+// "YYYY.MM.DD HH:MM:SS[.mmm]"; lines that do not parse (headers) are skipped.
+// Without a file (or with "-") a synthetic BTCUSD-like walk of 3M ticks is
+// replayed. range_bar_points > 0 runs the signal path on range bars instead of
+// M1 time bars, to compare both on the same feed.
+// Also times EA_Warmup over 100k M1 bars and exits with 1 when it takes a
+// millisecond or more (the warmup budget).
+// Per-stage numbers need a core built with -DEA_CORE_PROFILE=ON.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include "ea_api.h"
+#include "feeds.h"
+
+namespace {
+
+struct Tick { int64_t t; double bid, ask; };
+
+bool parse_line(const char* s, Tick& out){
+    int Y, M, D, h, m, sec;
+    double bid, ask;
+    if(std::sscanf(s, "%d.%d.%d %d:%d:%d%*[^,],%lf,%lf", &Y,&M,&D,&h,&m,&sec,&bid,&ask)==8 ||
+       std::sscanf(s, "%d.%d.%d %d:%d:%d,%lf,%lf", &Y,&M,&D,&h,&m,&sec,&bid,&ask)==8){
+        std::tm tm = {};
+        tm.tm_year = Y-1900; tm.tm_mon = M-1; tm.tm_mday = D;
+        tm.tm_hour = h; tm.tm_min = m; tm.tm_sec = sec;
+        out = { (int64_t)timegm(&tm), bid, ask };
+        return true;
+    }
+    long long t;
+    if(std::sscanf(s, "%lld,%lf,%lf", &t, &bid, &ask)==3){ out = { (int64_t)t, bid, ask }; return true; }
+    return false;
+}
+
+bool load(const char* path, std::vector<Tick>& ticks){
+    FILE* f = std::fopen(path, "r");
+    if(!f) return false;
+    char line[256];
+    Tick tk;
+    while(std::fgets(line, sizeof(line), f)) if(parse_line(line, tk)) ticks.push_back(tk);
+    std::fclose(f);
+    return true;
+}
+
+// Same walk as tests/test_alloc_free.cpp: 40 ticks per minute, digits=2.
+void synth(std::vector<Tick>& ticks, int64_t n){
+    ea::tools::Walk w{12345, 60000.0};
+    ticks.reserve((size_t)n);
+    for(int64_t i=0;i<n;++i){
+        const double px = w.step();
+        ticks.push_back({ 1700000000 + i/40, px, px + 0.20 });
+    }
+}
+
+// EA_Warmup over n walk bars, best of a few calls (ms).
+double warmup_ms(int32_t n){
+    std::vector<int64_t> t(n);
+    std::vector<double> o(n), hi(n), lo(n), cl(n);
+    ea::tools::Walk w{4242, 60000.0};
+    for(int32_t i=0;i<n;++i){
+        t[i] = 1700000040 + (int64_t)i*60;
+        o[i] = w.px; cl[i] = w.step();
+        hi[i] = std::max(o[i], cl[i]) + 1.0; lo[i] = std::min(o[i], cl[i]) - 1.0;
+    }
+    const int32_t h = EA_CreateContext();
+    EA_Init(h, "WARMUP", 1, 2, 0.01);
+    double best = 1e9;
+    for(int32_t r=0;r<5;++r){
+        const auto w0 = std::chrono::steady_clock::now();
+        EA_Warmup(h, t.data(), o.data(), hi.data(), lo.data(), cl.data(), n);
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - w0).count());
+    }
+    EA_DestroyContext(h);
+    return best;
+}
+
+const char* kStageName[EA_STAGE_COUNT] = {
+    "lookup", "bucket", "golden", "ma_signal", "sar_update", "plan", "tick (total)"
+};
+
+}
+
+int main(int argc, char** argv){
+    std::vector<Tick> ticks;
+    int32_t digits = 2; double point = 0.01, range_points = 0;
+    if(argc>1 && std::strcmp(argv[1], "-")!=0){
+        if(!load(argv[1], ticks)){ std::fprintf(stderr, "cannot read %s\n", argv[1]); return 1; }
+    } else {
+        synth(ticks, 3000000);
+    }
+    if(argc>3){ digits = std::atoi(argv[2]); point = std::atof(argv[3]); }
+    if(argc>4) range_points = std::atof(argv[4]);
+    if(ticks.empty()){ std::fprintf(stderr, "no ticks\n"); return 1; }
+
+    int32_t h = EA_CreateContext();
+    if(h<=0 || EA_Init(h, "BENCH", 1, digits, point)<0){ std::fprintf(stderr, "init failed\n"); return 1; }
+    EA_SetParamDouble(h, "range_bar_points", range_points);
+
+    // Replay once to warm caches and branch predictors, then measure a clean pass.
+    int32_t ticket = 0;
+    int64_t plans = 0;
+    for(int pass=0; pass<2; ++pass){
+        EA_Reset(h);
+        EA_ResetStats(h);
+        plans = 0;
+        auto w0 = std::chrono::steady_clock::now();
+        for(const Tick& tk : ticks){
+            int32_t action = 0;
+            EA_OnTick(h, tk.bid, tk.ask, tk.t, 0, &action);
+            if(action==EA_PLAN_ORDERS){
+                ++plans;
+                // Close right away so the level ladder moves and the next signal is not blocked.
+                EA_OnOrderClosed(h, ++ticket, (plans%13)!=0 ? 1 : 0, (plans%13)!=0 ? 0 : 1);
+            }
+        }
+        auto w1 = std::chrono::steady_clock::now();
+        if(pass==1){
+            double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(w1-w0).count();
+            std::printf("ticks %zu  plans %lld  wall %.1f ms  %.1f ns/tick\n",
+                        ticks.size(), (long long)plans, ns/1e6, ns/(double)ticks.size());
+        }
+    }
+    const double warm_ms = warmup_ms(100000);
+    std::printf("EA_Warmup  100000 bars %.3f ms%s\n", warm_ms, warm_ms<1.0 ? "" : "  OVER the 1 ms budget");
+
+    EA_Stats st;
+    EA_GetStats(h, &st);
+    const EA_CallStats& ot = st.fn[EA_FN_ONTICK];
+    if(st.enabled)
+        std::printf("EA_OnTick  p50 %.0f ns  p99 %.0f ns  p99.9 %.0f ns  max %.0f ns\n",
+                    ot.p50_ns, ot.p99_ns, ot.p999_ns, ot.max_ns);
+
+    EA_StageStats ps;
+    EA_GetStageStats(h, &ps);
+    if(!ps.enabled){
+        std::printf("stage profiler compiled out (configure with -DEA_CORE_PROFILE=ON)\n");
+        EA_DestroyContext(h);
+        return warm_ms<1.0 ? 0 : 1;
+    }
+    const double total = (double)ps.stage[EA_STAGE_TICK].total_cycles;
+    std::printf("\n%-14s %10s %8s %10s %8s %8s %8s %10s\n",
+                "stage", "calls", "share", "mean cyc", "p50", "p90", "p99", "max");
+    for(int32_t i=0;i<EA_STAGE_COUNT;++i){
+        const EA_StageRow& r = ps.stage[i];
+        std::printf("%-14s %10lld %7.1f%% %10.1f %8.0f %8.0f %8.0f %10.0f\n",
+                    kStageName[i], (long long)r.calls,
+                    total>0 ? 100.0*(double)r.total_cycles/total : 0.0,
+                    r.mean_cycles, r.p50_cycles, r.p90_cycles, r.p99_cycles, r.max_cycles);
+    }
+    std::printf("(%.3f cycles/ns; each stage includes its own timer overhead)\n", ps.cycles_per_ns);
+    EA_DestroyContext(h);
+    return warm_ms<1.0 ? 0 : 1;
+}
@@ -3,8 +3,13 @@
 extern "C" {
 #endif
 
-#define EA_API __declspec(dllexport)
-#define EA_CALL __stdcall
+#ifdef _WIN32
+  #define EA_API __declspec(dllexport)
+  #define EA_CALL __stdcall
+#else
+  #define EA_API
+  #define EA_CALL
+#endif
 
 #include <stdint.h>
 
@@ -40,6 +45,15 @@ EA_API int32_t  EA_CALL EA_Init(int32_t handle,
 // Reset internal indicators/state (keeps level)
 EA_API void     EA_CALL EA_Reset(int32_t handle);
 
+// Seed SAR/EMA and previous-candle state from M1 history (oldest bar first),
+// so the first live tick can already evaluate signals. Only the newest week
+// of bars is replayed (the SAR starts at its first bar). Returns bars used.
+EA_API int32_t  EA_CALL EA_Warmup(int32_t handle,
+                                  const int64_t* time,
+                                  const double* o, const double* h,
+                                  const double* l, const double* c,
+                                  int32_t n);
+
 // ====== Tick → plan orders ======
 // hasOpenPosition: pass 1 if MT4 detects any open/pending owned by this EA (single-trade enforcement)
 EA_API int32_t  EA_CALL EA_OnTick(int32_t handle,
@@ -48,6 +62,18 @@ EA_API int32_t  EA_CALL EA_OnTick(int32_t handle,
                                   int32_t hasOpenPosition,
                                   int32_t* action_out);
 
+// A run of ticks (columns, oldest first) through the same pipeline, e.g. a
+// chunk of a stored tick history. Stops after the first tick that plans
+// (action_out = EA_PLAN_ORDERS, plan readable as after EA_OnTick) so the
+// caller can act on it and resume. Returns the ticks consumed, -1 on a bad
+// handle, -2 on null columns or n < 0. Not timed as EA_FN_ONTICK calls.
+EA_API int32_t  EA_CALL EA_OnTicks(int32_t handle,
+                                   const int64_t* time_epoch_sec,
+                                   const double* bid, const double* ask,
+                                   int32_t n,
+                                   int32_t hasOpenPosition,
+                                   int32_t* action_out);
+
 // ====== Read planned orders after EA_PLAN_ORDERS ======
 EA_API int32_t  EA_CALL EA_PlanOrdersCount(int32_t handle);
 EA_API int32_t  EA_CALL EA_PlanOrderGet(int32_t handle, int32_t index,
@@ -69,13 +95,372 @@ EA_API int32_t  EA_CALL EA_AdviseSL(int32_t handle, double current_price,
                                     double* new_sl_out, int32_t* should_modify_out);
 
 // ====== Runtime knobs (flexible) ======
+// Strategy keys (either call, or a config file), and what each does with its value:
+//   "paused", "conflate", "degrade_on_overrun"   nonzero = on
+//   "conflate_points"                            clamped to >= 0
+//   "htf_sar_confirm"                            clamped to 0..EA_TF_COUNT-1
+//   "base_sl_points"                             1..INT32_MAX, else rejected
+//   "entry_offset_points", "range_bar_points"    0..INT32_MAX, else rejected
+//   "sar_step", "sar_max"                        (0, 1], else rejected
+//   "lots"                                       > 0, else rejected
+//   "budget_order_ms", "budget_ui_ms"            as given, <= 0 = no budget
+//   "budget_recover_ms"                          clamped to >= 0
+// NaN and infinities are rejected for every key. A rejected value or an
+// unknown key changes nothing (a config file holding one fails to load).
+// Each change publishes a new immutable snapshot that the context picks up at
+// its next call; safe from any thread.
+// The setters themselves are not timed (EA_FN_SET_FLAG/SET_PARAM stay at 0).
+// Range bars: with "range_bar_points" > 0 the signal candle closes once its
+// bid high - bid low reaches that many points instead of on the minute. The
+// completing tick closes the bar and returns its plan; the next tick opens the
+// next bar. Signals, EMAs and plans follow range bars. The multi-timeframe bars stay clock-based, and EA_Warmup still
+// seeds from M1 bars. 0 (default) = M1 time bars.
 EA_API void     EA_CALL EA_SetFlag(int32_t handle, const char* key, int32_t value);   // e.g., "paused" 0/1
-EA_API void     EA_CALL EA_SetParamDouble(int32_t handle, const char* key, double value); // e.g., "min_spread_points"
+EA_API void     EA_CALL EA_SetParamDouble(int32_t handle, const char* key, double value); // e.g., "sar_step"
+// Tick conflation: EA_SetFlag "conflate" 0/1, EA_SetParamDouble "conflate_points".
+// Counters report how many ticks took the full path (sar_update) vs the conflated fast path.
+EA_API int32_t  EA_CALL EA_TickCounters(int32_t handle, int64_t* full_ticks, int64_t* conflated_ticks);
 
 // ====== Diagnostics ======
 EA_API const char* EA_CALL EA_LastError(int32_t handle);
 EA_API const char* EA_CALL EA_Version();
 
+// ====== Latency statistics (per context) ======
+// One entry per exported call that takes a handle. Latencies come from a single
+// TSC read pair per call; build with EA_CORE_STATS=0 to remove the reads
+// (EA_GetStats then reports enabled=0 and zero counts).
+enum EA_StatFn : int32_t {
+    EA_FN_INIT = 0, EA_FN_RESET, EA_FN_WARMUP, EA_FN_ONTICK,
+    EA_FN_PLAN_COUNT, EA_FN_PLAN_GET,
+    EA_FN_ORDER_PLACED, EA_FN_ORDER_FILLED, EA_FN_ORDER_CLOSED,
+    EA_FN_CURRENT_LEVEL, EA_FN_APPLY_LEVEL, EA_FN_ADVISE_SL,
+    EA_FN_SET_FLAG, EA_FN_SET_PARAM, EA_FN_TICK_COUNTERS, EA_FN_LAST_ERROR,
+    EA_FN_COUNT
+};
+
+// All fields are 8 bytes wide so the layout is the same under MQL4's packing.
+typedef struct EA_CallStats {
+    int64_t calls;
+    double  mean_ns;
+    double  max_ns;
+    double  p50_ns, p90_ns, p99_ns, p999_ns;  // histogram upper bounds (<=12.5% error)
+} EA_CallStats;
+
+typedef struct EA_Stats {
+    int32_t enabled;        // 0 when compiled out
+    int32_t fn_count;       // EA_FN_COUNT
+    double  cycles_per_ns;  // timestamp rate used for the conversion
+    EA_CallStats fn[EA_FN_COUNT];
+} EA_Stats;
+
+EA_API int32_t  EA_CALL EA_GetStats(int32_t handle, EA_Stats* out);
+// Safe from any thread: the histograms are cleared by the context's next
+// timed call (on its calling thread), which is then the first one recorded.
+EA_API void     EA_CALL EA_ResetStats(int32_t handle);
+
+// ====== Pipeline-stage profile of EA_OnTick (build with EA_CORE_PROFILE=1) ======
+// Cycle counts per stage; EA_STAGE_TICK is the whole call including lookup.
+// Cleared by EA_ResetStats.
+enum EA_Stage : int32_t {
+    EA_STAGE_LOOKUP = 0,  // handle -> context
+    EA_STAGE_BUCKET,      // price conversion, M1 bucketing, OHLC aggregation
+    EA_STAGE_GOLDEN,      // golden-candle validator + SAR flip test
+    EA_STAGE_MA,          // ma_up_signal
+    EA_STAGE_SAR,         // sar_update
+    EA_STAGE_PLAN,        // plan construction
+    EA_STAGE_TICK,
+    EA_STAGE_COUNT
+};
+
+typedef struct EA_StageRow {
+    int64_t calls;
+    int64_t total_cycles;
+    double  mean_cycles;
+    double  p50_cycles, p90_cycles, p99_cycles;
+    double  max_cycles;
+} EA_StageRow;
+
+typedef struct EA_StageStats {
+    int32_t enabled;        // 0 when compiled out
+    int32_t stage_count;    // EA_STAGE_COUNT
+    double  cycles_per_ns;
+    EA_StageRow stage[EA_STAGE_COUNT];
+} EA_StageStats;
+
+EA_API int32_t  EA_CALL EA_GetStageStats(int32_t handle, EA_StageStats* out);
+
+// ====== Span trace (process-wide, all contexts) ======
+// Fixed-size ring of pipeline spans (tick, candle close, signal evaluation,
+// plan publish, order callbacks). Off by default; EA_TraceEnable returns the
+// previous state (-1 when compiled out). EA_TraceDump writes the spans of the
+// last `last_seconds` (all retained when <= 0) as Chrome trace-event JSON and
+// returns the number of events, -1 on I/O error.
+EA_API int32_t  EA_CALL EA_TraceEnable(int32_t on);
+EA_API int32_t  EA_CALL EA_TraceDump(const char* path, double last_seconds);
+
+// ====== Metrics exporter (process-wide, all contexts) ======
+// Serves Prometheus text format on http://127.0.0.1:<port>/metrics from a
+// background thread: ticks, signals by type, plans, level distribution,
+// errors and call latency quantiles. port 0 picks a free port; returns the
+// bound port or -1. Call EA_MetricsStop before the DLL is unloaded.
+EA_API int32_t  EA_CALL EA_MetricsStart(int32_t port);
+EA_API void     EA_CALL EA_MetricsStop();
+// Same page rendered into buf (NUL-terminated, truncated to cap-1).
+// Returns the full length, so a second call can size the buffer.
+EA_API int32_t  EA_CALL EA_MetricsRender(char* buf, int32_t cap);
+
+// ====== Latency budget watchdog ======
+// Every timed call is checked against a budget: "budget_order_ms" (default
+// 100) for EA_OnTick, plan reads, order callbacks and EA_AdviseSL, and
+// "budget_ui_ms" (default 500) for the rest; set with EA_SetParamDouble or a
+// config file, <=0 disables, applied from the context's next timed call on.
+// With EA_SetFlag("degrade_on_overrun", 1) an overrun puts the context in
+// degraded mode (trace spans and the metrics latency summary are shed) until
+// no overrun is seen for "budget_recover_ms" (default 1000).
+// Returns 1, 0 when compiled out (EA_CORE_STATS=0), -1 on a bad handle.
+typedef struct EA_BudgetStatus {
+    int32_t degraded;           // 1 while in degraded mode
+    int32_t last_fn;            // EA_StatFn of the latest overrun, -1 if none
+    double  last_overrun_ms;    // duration of the latest overrun
+    int64_t overruns;           // all functions
+    int64_t degraded_entries;
+    double  degraded_ms;        // total time degraded, including the current episode
+    int64_t overruns_by_fn[EA_FN_COUNT];
+} EA_BudgetStatus;
+
+EA_API int32_t  EA_CALL EA_GetBudgetStatus(int32_t handle, EA_BudgetStatus* out);
+
+// ====== Account-level risk (process-wide, all contexts) ======
+// Limits are shared by every context and checked when a plan is about to be
+// emitted; a vetoed plan is simply not emitted (EA_OnTick returns 0). A plan
+// that passes reserves its legs (and its high-level slot) at once, so plans
+// emitted concurrently cannot overshoot a limit together; a leg keeps its
+// reservation until it fills or is cancelled, or the next close is evaluated
+// before it is placed.
+// EA_SetAccountLimit keys (0 = off):
+//   "daily_loss"      realized loss of the UTC day (account currency) that stops new plans
+//   "max_open_lots"   filled and reserved lots across contexts, including the plan's legs
+//   "high_level", "max_high_level"  at most M contexts with open or reserved exposure at level >= N
+enum EA_RiskVeto : int32_t {
+    EA_RISK_OK = 0,
+    EA_RISK_KILL_SWITCH,
+    EA_RISK_DAILY_LOSS,
+    EA_RISK_EXPOSURE,
+    EA_RISK_HIGH_LEVEL,
+    EA_RISK_COUNT
+};
+
+typedef struct EA_AccountRisk {
+    int32_t kill_switch;
+    int32_t day;                // UTC day (epoch days) of daily_pnl
+    double  daily_pnl;
+    double  open_lots;          // filled lots plus lots reserved by unfilled legs
+    int32_t active_contexts;    // contexts with open or reserved exposure
+    int32_t high_level_active;  // of which at level >= high_level
+    int64_t vetoes[EA_RISK_COUNT];
+} EA_AccountRisk;
+
+EA_API void     EA_CALL EA_SetAccountLimit(const char* key, double value);
+// Global kill switch: while on, no context emits a plan (effective on its next
+// tick). Returns the previous state.
+EA_API int32_t  EA_CALL EA_KillSwitch(int32_t on);
+// Realized profit (negative = loss) of a closed order, in account currency.
+EA_API void     EA_CALL EA_ReportClosedProfit(int32_t handle, double profit);
+EA_API int32_t  EA_CALL EA_GetAccountRisk(EA_AccountRisk* out);
+
+// ====== Multi-timeframe bars (per context) ======
+// M1, M5, M15 and H1 OHLCV bars built from the bid of every EA_OnTick call
+// (including paused ticks) and from the newest week of EA_Warmup's M1 series;
+// ticks is the tick volume (0 for warmup bars). Each timeframe keeps its forming bar plus its
+// closed bars: a week of M1 (the history below), the last 64 of the others.
+// Higher timeframes also run their own SAR on closed bars:
+// with EA_SetFlag("htf_sar_confirm", EA_TF_M5..EA_TF_H1) a plan is only emitted
+// while that SAR is rising and under the signal close (0 = off, the default).
+enum EA_Timeframe : int32_t {
+    EA_TF_M1 = 0, EA_TF_M5, EA_TF_M15, EA_TF_H1,
+    EA_TF_COUNT
+};
+
+typedef struct EA_Bar {
+    int64_t time;           // bar open (epoch seconds)
+    double  open, high, low, close;
+    int64_t ticks;
+} EA_Bar;
+
+// Copies up to count bars of tf, newest first, starting at shift (0 = the
+// forming bar, as in MQL4's iOpen/iClose). Returns the number copied, -1 on a
+// bad handle, -2 on a bad timeframe or range.
+EA_API int32_t  EA_CALL EA_GetBars(int32_t handle, int32_t tf, int32_t shift, int32_t count, EA_Bar* out);
+// SAR of a timeframe (for EA_TF_M1 the tick-driven SAR of the signal path).
+// Returns 1, 0 while it has no bar yet, -1 on a bad handle, -2 on a bad tf.
+EA_API int32_t  EA_CALL EA_GetTfSar(int32_t handle, int32_t tf, double* sar, int32_t* dir);
+
+// ====== M1 history (per context) ======
+// Completed M1 bars of the last week (10080), as kept for EA_GetBars(EA_TF_M1).
+// EA_HistoryCopy fills the bars [shift, shift+count) back from the newest
+// closed bar, oldest first (MQL4 CopyRates order), into whichever arrays are
+// non-null; spreads are ask-bid in points (0 for warmup bars). Returns the
+// number of bars copied, -1 on a bad handle, -2 on a negative shift or count.
+EA_API int32_t  EA_CALL EA_HistoryCount(int32_t handle);
+EA_API int32_t  EA_CALL EA_HistoryCopy(int32_t handle, int32_t shift, int32_t count,
+                                       int64_t* time, double* open, double* high,
+                                       double* low, double* close, int64_t* ticks,
+                                       int32_t* spread_min, int32_t* spread_max);
+
+// ====== Config file (hot reload) ======
+// key=value lines with the strategy keys above; '#' starts a comment. A file
+// is applied as one snapshot or not at all (unknown key, bad value: the
+// previous config stays and EA_LastError names the line). EA_ConfigLoad
+// applies path now and remembers it; EA_ConfigPoll reloads it when its mtime
+// or size changed (one stat, call it from a timer). Return 1 when applied,
+// 0 when unchanged or no file, -1 on a bad handle, -2 on an error.
+EA_API int32_t  EA_CALL EA_ConfigLoad(int32_t handle, const char* path);
+EA_API int32_t  EA_CALL EA_ConfigPoll(int32_t handle);
+
+// ====== Sharded engine (many symbols, worker threads) ======
+// EA_ShardStart runs N worker threads (<=0: one per hardware thread, at most
+// 64), pinned to CPUs when pin is set. Each context belongs to the shard its
+// EA_Init symbol hashes to and only that worker runs it, so the submit calls
+// below are safe from any thread while the context itself is never locked.
+// While the engine runs, a context that receives submissions must not be
+// driven directly (EA_OnTick, EA_OnOrder*); config and account calls stay
+// safe. Plans come back through EA_ShardPollPlan, in emission order per
+// context. EA_ShardStop finishes every queued message, then joins; call it
+// before the DLL is unloaded.
+enum EA_ShardEvent : int32_t {
+    EA_SHARD_ORDER_PLACED = 1,   // a = ticket, b = qualification code
+    EA_SHARD_ORDER_FILLED,       // a = ticket, price = fill price
+    EA_SHARD_ORDER_CLOSED        // a = ticket, b = closed_by_tp | closed_by_sl<<1
+};
+
+typedef struct EA_ShardLeg {
+    double  entry, sl, tp, lots;
+    int64_t qualification_code;
+} EA_ShardLeg;
+
+typedef struct EA_ShardPlan {
+    int32_t     handle;
+    int32_t     count;          // legs used
+    int64_t     time;           // tick that emitted the plan
+    EA_ShardLeg legs[8];
+} EA_ShardPlan;
+
+// Returns the worker count (already running: the current one), -1 when
+// compiled out.
+EA_API int32_t  EA_CALL EA_ShardStart(int32_t workers, int32_t pin);
+EA_API void     EA_CALL EA_ShardStop();
+// Queue a tick / order event for the context's shard. Return 1 when queued,
+// 0 when the shard's queue is full or the engine is stopped (retry or drop),
+// -1 on a bad handle, -2 on a bad event.
+EA_API int32_t  EA_CALL EA_ShardSubmitTick(int32_t handle, double bid, double ask,
+                                           int64_t time_epoch_sec, int32_t hasOpenPosition);
+EA_API int32_t  EA_CALL EA_ShardSubmitOrder(int32_t handle, int32_t event, int32_t a,
+                                            int32_t b, double price);
+// Returns 1 and fills out with the oldest waiting plan, 0 when none. Meant
+// for one polling thread; a call that overlaps another poll returns 0.
+EA_API int32_t  EA_CALL EA_ShardPollPlan(EA_ShardPlan* out);
+// Shard of a context while the engine runs, -1 otherwise.
+EA_API int32_t  EA_CALL EA_ShardOf(int32_t handle);
+
+// ====== Batched parameter sweeps (research) ======
+// One tick stream, many variants of the default strategy ("lanes"): each lane
+// has its own base_sl_points, entry_offset_points, sar_step, sar_max and level
+// (1..25), and plans exactly as a context with those settings fed the same
+// ticks with hasOpenPosition=0 (no bars, pause, conflation or account limits).
+// The per-lane SAR runs in an AVX-512 / AVX2 / scalar kernel picked at
+// EA_BatchCreate: EA_ISA_AUTO takes the best the CPU has, a lower value caps it.
+enum EA_Isa : int32_t {
+    EA_ISA_AUTO = -1,
+    EA_ISA_SCALAR = 0,
+    EA_ISA_AVX2,
+    EA_ISA_AVX512
+};
+
+typedef struct EA_BatchLane {
+    double  sar;            // 0 before the first tick
+    double  entry, sl;      // last plan
+    double  tp[3];          // last plan's legs (0 past legs)
+    int64_t plans;
+    int64_t last_plan_time;
+    int32_t dir;            // SAR direction, +1/-1 (0 before the first tick)
+    int32_t legs;
+} EA_BatchLane;
+
+// Returns a batch id (>0), -2 on bad arguments (1..4096 lanes) or when 16
+// batches already exist. A batch is driven from one thread at a time.
+// EA_BatchDestroy frees the id, not the memory (reused by the next batch in
+// that slot), so a call racing it is harmless but its results are undefined.
+EA_API int32_t  EA_CALL EA_BatchCreate(int32_t lanes, int32_t digits, double point, int32_t isa);
+EA_API void     EA_CALL EA_BatchDestroy(int32_t batch);
+// Kernel in use (EA_Isa), -1 on a bad batch.
+EA_API int32_t  EA_CALL EA_BatchIsa(int32_t batch);
+// lane -1 sets every lane. Returns 1, 0 on an unknown key, -1 on a bad batch,
+// -2 on a bad lane or value.
+EA_API int32_t  EA_CALL EA_BatchSetParam(int32_t batch, int32_t lane, const char* key, double value);
+// Returns the number of lanes that planned on this tick, -1 on a bad batch.
+EA_API int32_t  EA_CALL EA_BatchOnTick(int32_t batch, double bid, double ask, int64_t time_epoch_sec);
+// n ticks in one call; returns the lane plans emitted, -1 / -2 on bad arguments.
+EA_API int32_t  EA_CALL EA_BatchRun(int32_t batch, const int64_t* time, const double* bid,
+                                    const double* ask, int32_t n);
+EA_API int32_t  EA_CALL EA_BatchGetLane(int32_t batch, int32_t lane, EA_BatchLane* out);
+
+// ====== Execution quality (per context) ======
+// Recorded from the order callbacks, per (level at plan time, qualification
+// code): slippage of EA_OnOrderFilled's fill_price against the planned entry,
+// the delay from the plan's emission (the EA_OnTick that returned
+// EA_PLAN_ORDERS) to EA_OnOrderPlaced, and from EA_OnOrderPlaced to the fill.
+// A placement is matched to the first unplaced leg of the current plan with
+// its qualification code; a fill to its ticket. Memory is constant: quantiles
+// come from log-linear histograms (<=12.5% error), rows for up to 40 keys.
+typedef struct EA_ExecDist {
+    int64_t count;
+    double  mean;
+    double  p50, p90, p99;
+    double  worst;          // largest sample
+} EA_ExecDist;
+
+typedef struct EA_ExecStats {
+    int32_t level;
+    int32_t qualification_code;
+    EA_ExecDist slippage_points;    // fill - planned entry; > 0 is a worse BuyStop fill
+    EA_ExecDist place_delay_ms;     // plan emission -> EA_OnOrderPlaced
+    EA_ExecDist fill_time_ms;       // EA_OnOrderPlaced -> EA_OnOrderFilled
+} EA_ExecStats;
+
+// Copies up to cap rows in order of first use. Returns the number of keys in
+// use (may exceed cap), -1 on a bad handle, -2 on a null out with cap > 0.
+EA_API int32_t  EA_CALL EA_GetExecStats(int32_t handle, EA_ExecStats* out, int32_t cap);
+
+// ====== Signal funnel (per context) ======
+// Where the EA_OnTick decision chain stops. Every evaluated candle close
+// counts in EA_FUNNEL_CANDLES and in exactly one outcome: not golden, no
+// trigger, HTF veto, risk veto or planned; SAR up / MA up count the candles
+// on which that trigger held. Ticks returned early (paused, in position) are
+// counted per tick. Buckets are the UTC hour of day of the candle's open (of
+// the tick for the early returns). Always on, monotonic for the context's
+// lifetime; also exported as ea_funnel_total.
+enum EA_FunnelGate : int32_t {
+    EA_FUNNEL_PAUSED = 0,       // ticks
+    EA_FUNNEL_IN_POSITION,      // ticks with hasOpenPosition
+    EA_FUNNEL_CANDLES,          // candle closes evaluated
+    EA_FUNNEL_SAR_UP,
+    EA_FUNNEL_MA_UP,
+    EA_FUNNEL_NOT_GOLDEN,
+    EA_FUNNEL_NO_TRIGGER,       // golden, but neither SAR nor MA up
+    EA_FUNNEL_HTF_VETO,         // "htf_sar_confirm" disagreed
+    EA_FUNNEL_RISK_VETO,        // account limit or kill switch
+    EA_FUNNEL_PLANNED,
+    EA_FUNNEL_COUNT
+};
+
+typedef struct EA_Funnel {
+    int64_t total[EA_FUNNEL_COUNT];
+    int64_t by_hour[24][EA_FUNNEL_COUNT];
+} EA_Funnel;
+
+// Returns 1, -1 on a bad handle, -2 on a null out.
+EA_API int32_t  EA_CALL EA_GetFunnel(int32_t handle, EA_Funnel* out);
+
 #ifdef __cplusplus
 }
 #endif
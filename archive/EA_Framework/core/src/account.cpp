@@ -0,0 +1,43 @@
+#include "account.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace ea {
+
+Account g_account;
+
+void account_add_pnl(int64_t day, int64_t cents){
+    std::atomic<int64_t>& w = g_account.day_pnl.v;
+    int64_t cur = w.load(std::memory_order_relaxed), next;
+    do {
+        const int64_t base = pnl_day(cur)==day ? pnl_cents(cur) : 0;
+        if(pnl_day(cur) > day) return;   // late report for a closed day
+        next = (day << 48) | (int64_t)((uint64_t)(base + cents) & ((1ull<<48)-1));
+    } while(!w.compare_exchange_weak(cur, next, std::memory_order_relaxed));
+}
+
+void account_set_limit(const char* key, double value){
+    Account& a = g_account;
+    if(!key) return;
+    if(!std::strcmp(key,"daily_loss"))          a.daily_loss_cents.store((int64_t)std::llround(std::max(0.0, value)*100), std::memory_order_relaxed);
+    else if(!std::strcmp(key,"max_open_lots"))  a.max_open_micro.store(lots_to_micro(std::max(0.0, value)), std::memory_order_relaxed);
+    else if(!std::strcmp(key,"high_level"))     a.high_level.store((int32_t)std::max(0.0, std::min(value, (double)kMaxLevel)), std::memory_order_relaxed);
+    else if(!std::strcmp(key,"max_high_level")) a.max_high.store((int32_t)std::max(0.0, value), std::memory_order_relaxed);
+}
+
+void account_snapshot(EA_AccountRisk* out){
+    const Account& a = g_account;
+    std::memset(out, 0, sizeof(*out));
+    const int64_t w = a.day_pnl.v.load(std::memory_order_relaxed);
+    out->kill_switch = a.kill.load(std::memory_order_relaxed);
+    out->day         = (int32_t)pnl_day(w);
+    out->daily_pnl   = (double)pnl_cents(w)/100.0;
+    out->open_lots   = (double)a.open_micro.v.load(std::memory_order_relaxed)/1e6;
+    const int32_t n  = a.high_level.load(std::memory_order_relaxed);
+    for(int32_t l=(n>0?n:1); l<=kMaxLevel; ++l) out->high_level_active += a.active_by_level[l].load(std::memory_order_relaxed);
+    for(int32_t l=1; l<=kMaxLevel; ++l) out->active_contexts += a.active_by_level[l].load(std::memory_order_relaxed);
+    for(int32_t i=0;i<EA_RISK_COUNT;++i) out->vetoes[i] = a.vetoes[i].load(std::memory_order_relaxed);
+}
+
+} // namespace ea
@@ -0,0 +1,93 @@
+#pragma once
+// Account-level risk shared by every context (all charts in the terminal).
+// Contexts push lock-free deltas (fills, closes, realized P&L); a plan is
+// vetoed in O(1) at emission time if it would break a limit or the global
+// kill switch is on, and otherwise reserves its share of the limited
+// exposure. Each shared word lives on its own cache line.
+#include <stdint.h>
+#include <atomic>
+#include "ea_api.h"
+
+namespace ea {
+
+static constexpr int32_t kMaxLevel = 25;
+
+struct alignas(64) AlignedI64 { std::atomic<int64_t> v{0}; };
+
+struct Account {
+    // Realized P&L of the current UTC day: day<<48 | cents (48-bit two's complement),
+    // so a report from a new day restarts the sum in the same CAS.
+    AlignedI64 day_pnl;
+    AlignedI64 open_micro;                      // filled + reserved lots * 1e6, all contexts
+    // Contexts with open exposure or a reserved slot, by the level they took it at.
+    alignas(64) std::atomic<int32_t> active_by_level[kMaxLevel+1] = {};
+    alignas(64) std::atomic<int32_t> kill{0};
+    // Limits (0 = off), written rarely from EA_SetAccountLimit.
+    alignas(64) std::atomic<int64_t> daily_loss_cents{0};
+    std::atomic<int64_t> max_open_micro{0};
+    std::atomic<int32_t> high_level{0};         // N for "at most M contexts at level >= N"
+    std::atomic<int32_t> max_high{0};           // M
+    alignas(64) std::atomic<int64_t> vetoes[EA_RISK_COUNT] = {};
+};
+extern Account g_account;
+
+inline int64_t lots_to_micro(double lots){ return (int64_t)(lots*1e6 + (lots<0 ? -0.5 : 0.5)); }
+inline int64_t pnl_day(int64_t word){ return word >> 48; }
+inline int64_t pnl_cents(int64_t word){ return (int64_t)((uint64_t)word << 16) >> 16; }
+
+// Reason a plan must not be emitted (EA_RISK_OK = go). day: UTC day of the
+// signal, level: the context's level, add_micro: lots the plan would add,
+// registered: the context already counts in active_by_level.
+// A plan that goes reserves what the limits that are on need: add_micro in
+// open_micro (*micro_out) under max_open_lots, and a slot in
+// active_by_level[level] (*slot_out) under the high-level limit. Both are
+// read-modify-writes rolled back on a veto, so contexts on different threads
+// cannot both pass a limit with room for one. The caller gives them back
+// (fill, cancel, next plan, destroy).
+inline int32_t account_veto(int64_t day, int32_t level, int64_t add_micro, bool registered,
+                            int64_t* micro_out, bool* slot_out){
+    Account& a = g_account;
+    int32_t why = EA_RISK_OK;
+    int64_t micro = 0;
+    bool slot = false;
+    if(a.kill.load(std::memory_order_acquire)) why = EA_RISK_KILL_SWITCH;
+    else {
+        const int64_t loss = a.daily_loss_cents.load(std::memory_order_relaxed);
+        const int64_t w    = a.day_pnl.v.load(std::memory_order_relaxed);
+        const int64_t maxo = a.max_open_micro.load(std::memory_order_relaxed);
+        const int32_t n    = a.high_level.load(std::memory_order_relaxed);
+        if(loss>0 && pnl_day(w)==day && -pnl_cents(w) >= loss) why = EA_RISK_DAILY_LOSS;
+        else if(maxo>0){
+            int64_t cur = a.open_micro.v.load(std::memory_order_relaxed);
+            do {
+                if(cur + add_micro > maxo){ why = EA_RISK_EXPOSURE; break; }
+            } while(!a.open_micro.v.compare_exchange_weak(cur, cur + add_micro, std::memory_order_relaxed));
+            if(!why) micro = add_micro;
+        }
+        if(!why && n>0 && level>=n){
+            // Take the slot first, then count: of two racing contexts at most
+            // the one that fits sees room. Bounded by kMaxLevel.
+            const int32_t l0 = level>kMaxLevel ? kMaxLevel : level;
+            if(!registered) a.active_by_level[l0].fetch_add(1, std::memory_order_acq_rel);
+            int32_t active = 0;
+            for(int32_t l=n; l<=kMaxLevel; ++l) active += a.active_by_level[l].load(std::memory_order_acquire);
+            if(active - (registered ? 0 : 1) >= a.max_high.load(std::memory_order_relaxed)){
+                why = EA_RISK_HIGH_LEVEL;
+                if(!registered) a.active_by_level[l0].fetch_sub(1, std::memory_order_relaxed);
+                if(micro) a.open_micro.v.fetch_sub(micro, std::memory_order_relaxed);
+                micro = 0;
+            }
+            else slot = !registered;
+        }
+    }
+    if(why) a.vetoes[why].fetch_add(1, std::memory_order_relaxed);
+    *micro_out = micro;
+    *slot_out = slot;
+    return why;
+}
+
+void account_add_pnl(int64_t day, int64_t cents);
+void account_set_limit(const char* key, double value);
+void account_snapshot(EA_AccountRisk* out);
+
+} // namespace ea
@@ -0,0 +1,335 @@
+#include "batch.h"
+#include "strategy.h"
+#include "account.h"
+#include <mutex>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define EA_BATCH_X86 1
+  #include <immintrin.h>
+#else
+  #define EA_BATCH_X86 0
+#endif
+
+namespace ea {
+
+namespace {
+
+// Config defaults of a fresh context
+struct Lane {
+    int64_t base_sl = 10000;
+    int64_t offset  = 3500;
+    int32_t level   = 1;
+    int32_t legs    = 0;
+    int64_t plans   = 0;
+    int64_t last_plan_time = 0;
+    int64_t entry = 0, sl = 0, tp[3] = {};
+};
+static_assert(std::is_trivially_destructible<Lane>::value, "lanes are rebuilt in place, never destroyed");
+
+// The shared M1 candle and EMAs, field names as HotState for the policies.
+struct Shared {
+    int64_t last_minute = -1;
+    int64_t last_close  = kNoPrice;
+    int64_t last_high   = kNoHigh;
+    int64_t last_low    = kNoLow;
+    int64_t last_open   = kNoPrice;
+    double  ema_fast = NAN, ema_slow = NAN;
+};
+
+// SAR columns, padded to a multiple of 8 lanes; dir is +-1.0 so the kernels
+// can flip it with a sign xor.
+struct SarCols {
+    double *sar, *ep, *af, *dir, *step, *amax;
+};
+
+using Kernel = void (*)(const SarCols&, int32_t n, double high, double low);
+
+// A slot's batch and its columns are sized for kMaxBatchLanes on the slot's
+// first use and never freed, like the context pool: EA_BatchDestroy only
+// unpublishes it, so a call still running on a destroyed id can't touch freed
+// memory. Only the first n lanes are initialized, so pages past them stay
+// uncommitted.
+struct Batch {
+    int32_t n = 0, padded = 0, isa = EA_ISA_SCALAR;
+    double  scale = 1;
+    Kernel  kernel = nullptr;
+    bool    sar_live = false;         // first SAR step done (every lane at once)
+    Shared  k;
+    double* mem = nullptr;            // the six SAR columns
+    SarCols col{};
+    Lane*   lane = nullptr;
+    int32_t* planned = nullptr;       // lanes that planned on the current tick
+};
+
+std::mutex g_batch_mtx;               // create/destroy only
+std::atomic<Batch*> g_batch[kMaxBatches] = {};   // published batches
+Batch* g_store[kMaxBatches] = {};                 // slot storage, kept once allocated
+
+Batch* B(int32_t id){
+    if(id<1 || id>kMaxBatches) return nullptr;
+    return g_batch[id-1].load(std::memory_order_acquire);
+}
+
+// Same rounding as state.cpp's to_points (half-to-even via rint).
+inline int64_t to_points(double px, double scale){ return (int64_t)std::rint(px*scale); }
+
+// ---- SAR kernels: ea::sar_step on every lane ----
+// std::min(a,b) is (b<a ? b : a) and std::max(a,b) is (a<b ? b : a); the
+// vector kernels keep those compares so ties and operand order match.
+
+void sar_scalar(const SarCols& c, int32_t n, double high, double low){
+    for(int32_t i=0;i<n;++i){
+        int d = (int)c.dir[i];
+        sar_step(c.sar[i], c.ep[i], c.af[i], d, c.step[i], c.amax[i], high, low);
+        c.dir[i] = d;
+    }
+}
+
+#if EA_BATCH_X86
+__attribute__((target("avx2")))
+void sar_avx2(const SarCols& c, int32_t n, double high, double low){
+    const __m256d H = _mm256_set1_pd(high), L = _mm256_set1_pd(low);
+    const __m256d zero = _mm256_setzero_pd(), sign = _mm256_set1_pd(-0.0);
+    for(int32_t i=0;i<n;i+=4){
+        const __m256d sar = _mm256_load_pd(c.sar+i), ep = _mm256_load_pd(c.ep+i);
+        const __m256d af  = _mm256_load_pd(c.af+i),  dir = _mm256_load_pd(c.dir+i);
+        const __m256d step = _mm256_load_pd(c.step+i), amax = _mm256_load_pd(c.amax+i);
+        const __m256d up = _mm256_cmp_pd(dir, zero, _CMP_GT_OQ);
+        __m256d s = _mm256_add_pd(sar, _mm256_mul_pd(af, _mm256_sub_pd(ep, sar)));
+        const __m256d s_up = _mm256_blendv_pd(s, L, _mm256_cmp_pd(L, s, _CMP_LT_OQ));
+        const __m256d s_dn = _mm256_blendv_pd(s, H, _mm256_cmp_pd(s, H, _CMP_LT_OQ));
+        s = _mm256_blendv_pd(s_dn, s_up, up);
+        const __m256d ext = _mm256_blendv_pd(_mm256_cmp_pd(L, ep, _CMP_LT_OQ), _mm256_cmp_pd(H, ep, _CMP_GT_OQ), up);
+        const __m256d nep = _mm256_blendv_pd(ep, _mm256_blendv_pd(L, H, up), ext);
+        const __m256d afs = _mm256_add_pd(af, step);
+        const __m256d naf = _mm256_blendv_pd(af, _mm256_blendv_pd(afs, amax, _mm256_cmp_pd(amax, afs, _CMP_LT_OQ)), ext);
+        const __m256d flip = _mm256_blendv_pd(_mm256_cmp_pd(H, s, _CMP_GT_OQ), _mm256_cmp_pd(L, s, _CMP_LT_OQ), up);
+        _mm256_store_pd(c.sar+i, _mm256_blendv_pd(s, nep, flip));
+        _mm256_store_pd(c.ep+i,  _mm256_blendv_pd(nep, _mm256_blendv_pd(H, L, up), flip));
+        _mm256_store_pd(c.af+i,  _mm256_blendv_pd(naf, step, flip));
+        _mm256_store_pd(c.dir+i, _mm256_xor_pd(dir, _mm256_and_pd(flip, sign)));
+    }
+}
+
+__attribute__((target("avx512f")))
+void sar_avx512(const SarCols& c, int32_t n, double high, double low){
+    const __m512d H = _mm512_set1_pd(high), L = _mm512_set1_pd(low);
+    const __m512d zero = _mm512_setzero_pd();
+    for(int32_t i=0;i<n;i+=8){
+        const __m512d sar = _mm512_load_pd(c.sar+i), ep = _mm512_load_pd(c.ep+i);
+        const __m512d af  = _mm512_load_pd(c.af+i),  dir = _mm512_load_pd(c.dir+i);
+        const __m512d step = _mm512_load_pd(c.step+i), amax = _mm512_load_pd(c.amax+i);
+        const __mmask8 up = _mm512_cmp_pd_mask(dir, zero, _CMP_GT_OQ);
+        __m512d s = _mm512_add_pd(sar, _mm512_mul_pd(af, _mm512_sub_pd(ep, sar)));
+        const __m512d s_up = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(L, s, _CMP_LT_OQ), s, L);
+        const __m512d s_dn = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(s, H, _CMP_LT_OQ), s, H);
+        s = _mm512_mask_blend_pd(up, s_dn, s_up);
+        const __mmask8 ext = (__mmask8)((up & _mm512_cmp_pd_mask(H, ep, _CMP_GT_OQ)) |
+                                        (~up & _mm512_cmp_pd_mask(L, ep, _CMP_LT_OQ)));
+        const __m512d nep = _mm512_mask_blend_pd(ext, ep, _mm512_mask_blend_pd(up, L, H));
+        const __m512d afs = _mm512_add_pd(af, step);
+        const __m512d naf = _mm512_mask_blend_pd(ext, af,
+                                _mm512_mask_blend_pd(_mm512_cmp_pd_mask(amax, afs, _CMP_LT_OQ), afs, amax));
+        const __mmask8 flip = (__mmask8)((up & _mm512_cmp_pd_mask(L, s, _CMP_LT_OQ)) |
+                                         (~up & _mm512_cmp_pd_mask(H, s, _CMP_GT_OQ)));
+        _mm512_store_pd(c.sar+i, _mm512_mask_blend_pd(flip, s, nep));
+        _mm512_store_pd(c.ep+i,  _mm512_mask_blend_pd(flip, nep, _mm512_mask_blend_pd(up, H, L)));
+        _mm512_store_pd(c.af+i,  _mm512_mask_blend_pd(flip, naf, step));
+        _mm512_store_pd(c.dir+i, _mm512_mask_sub_pd(dir, flip, zero, dir));
+    }
+}
+#endif
+
+int32_t best_isa(){
+#if EA_BATCH_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) return EA_ISA_AVX512;
+    if(__builtin_cpu_supports("avx2"))    return EA_ISA_AVX2;
+#endif
+    return EA_ISA_SCALAR;
+}
+
+Kernel kernel_for(int32_t isa){
+#if EA_BATCH_X86
+    if(isa==EA_ISA_AVX512) return sar_avx512;
+    if(isa==EA_ISA_AVX2)   return sar_avx2;
+#endif
+    return sar_scalar;
+}
+
+// The first SAR step initializes every lane (sar_step's NaN branch).
+void sar_first(Batch& b, double high, double low){
+    const SarCols& c = b.col;
+    for(int32_t i=0;i<b.padded;++i){
+        c.dir[i] = +1; c.ep[i] = high; c.sar[i] = low; c.af[i] = c.step[i];
+    }
+    b.sar_live = true;
+}
+
+// One tick through the default strategy (state.cpp's tick<DefaultStrategy> without
+// bars, pause, conflation or account limits: lanes never hold positions).
+// Returns the lanes that planned.
+int32_t tick(Batch& b, double bid_px, double ask_px, int64_t t){
+    using S = DefaultStrategy;
+    Shared& h = b.k;
+    const int64_t bid = to_points(bid_px, b.scale);
+    const int64_t ask = to_points(ask_px, b.scale);
+    const int64_t mb = (t/60)*60;
+    int32_t np = 0;
+
+    if(mb != h.last_minute){
+        const int64_t prev_close = h.last_close;
+        const double  prev_slow  = h.ema_slow;
+        bool valid = false, ma_buy = false;
+        int64_t range = 0;
+        if(h.last_high!=kNoHigh && h.last_low!=kNoLow && prev_close!=kNoPrice){
+            valid = true;
+            range = h.last_high - h.last_low;
+            S::MaPolicy::update(h.ema_fast, h.ema_slow, (double)prev_close);
+            ma_buy = std::isfinite(prev_slow) && h.ema_fast > prev_slow;
+        }
+        h.last_minute = mb;
+        S::Aggregator::open(h, bid, ask);
+        if(valid){
+            // Once per candle: plain loop over the lanes
+            const double close = (double)prev_close;
+            for(int32_t i=0;i<b.n;++i){
+                Lane& l = b.lane[i];
+                if(range < l.base_sl) continue;
+                const bool flip = b.col.dir[i]>0 && b.col.sar[i] < close;
+                if(!flip && !ma_buy) continue;
+                const LevelSchema& sch = S::Levels::legs(l.level);
+                l.entry = prev_close + l.offset;
+                l.sl    = l.entry - l.base_sl;
+                l.legs  = sch.n;
+                for(int32_t j=0;j<sch.n;++j) l.tp[j] = l.entry + l.base_sl*sch.rr[j];
+                ++l.plans;
+                l.last_plan_time = t;
+                b.planned[np++] = i;
+            }
+        }
+    } else {
+        S::Aggregator::fold(h, bid, ask);
+    }
+
+    const double hi = (double)std::max(bid,ask), lo = (double)std::min(bid,ask);
+    if(!b.sar_live){ sar_first(b, hi, lo); return np; }   // no lane has a SAR to flip yet
+    if(np==0){ b.kernel(b.col, b.padded, hi, lo); return np; }
+    // A lane that planned returns before its SAR update (as EA_OnTick does)
+    for(int32_t i=0, p=0;i<b.n;++i){
+        if(p<np && b.planned[p]==i){ ++p; continue; }
+        int d = (int)b.col.dir[i];
+        sar_step(b.col.sar[i], b.col.ep[i], b.col.af[i], d, b.col.step[i], b.col.amax[i], hi, lo);
+        b.col.dir[i] = d;
+    }
+    return np;
+}
+
+} // namespace
+
+int32_t batch_create(int32_t lanes, double scale, int32_t isa){
+    if(lanes<1 || lanes>kMaxBatchLanes || !(scale>0) || isa<EA_ISA_AUTO || isa>EA_ISA_AVX512) return -2;
+    const int32_t best = best_isa();
+    isa = isa==EA_ISA_AUTO ? best : std::min(isa, best);
+    std::lock_guard<std::mutex> lk(g_batch_mtx);
+    int32_t slot = 0;
+    while(slot<kMaxBatches && g_batch[slot].load(std::memory_order_relaxed)) ++slot;
+    if(slot==kMaxBatches) return -2;
+    if(!g_store[slot]){
+        Batch* b = new (std::nothrow) Batch();
+        if(!b) return -2;
+        b->mem = static_cast<double*>(::operator new[](6*(size_t)kMaxBatchLanes*sizeof(double), std::align_val_t(64), std::nothrow));
+        b->lane = static_cast<Lane*>(::operator new[](kMaxBatchLanes*sizeof(Lane), std::nothrow));
+        b->planned = new (std::nothrow) int32_t[kMaxBatchLanes];
+        if(!b->mem || !b->lane || !b->planned){
+            ::operator delete[](b->mem, std::align_val_t(64));
+            ::operator delete[](b->lane);
+            delete[] b->planned;
+            delete b;
+            return -2;
+        }
+        g_store[slot] = b;
+    }
+    Batch* b = g_store[slot];
+    b->n = lanes;
+    b->padded = (lanes + 7) & ~7;
+    b->isa = isa;
+    b->kernel = kernel_for(isa);
+    b->scale = scale;
+    b->sar_live = false;
+    b->k = Shared{};
+    const size_t per = (size_t)b->padded;
+    double* m = b->mem;
+    b->col = SarCols{ m, m+per, m+2*per, m+3*per, m+4*per, m+5*per };
+    for(size_t i=0;i<per;++i){
+        b->col.sar[i] = NAN; b->col.ep[i] = NAN; b->col.af[i] = 0.001; b->col.dir[i] = 0;
+        b->col.step[i] = 0.001; b->col.amax[i] = 0.2;
+    }
+    for(int32_t i=0;i<lanes;++i) new (&b->lane[i]) Lane();
+    g_batch[slot].store(b, std::memory_order_release);
+    return slot+1;
+}
+
+void batch_destroy(int32_t id){
+    std::lock_guard<std::mutex> lk(g_batch_mtx);
+    if(B(id)) g_batch[id-1].store(nullptr, std::memory_order_release);
+}
+
+int32_t batch_isa(int32_t id){
+    const Batch* b = B(id);
+    return b ? b->isa : -1;
+}
+
+int32_t batch_set_param(int32_t id, int32_t lane, const char* key, double v){
+    Batch* b = B(id);
+    if(!b) return -1;
+    if(!key || lane<-1 || lane>=b->n || !std::isfinite(v)) return -2;
+    const int32_t lo = lane<0 ? 0 : lane, hi = lane<0 ? b->n : lane+1;
+    for(int32_t i=lo;i<hi;++i){
+        Lane& l = b->lane[i];
+        if(!std::strcmp(key,"base_sl_points"))           { if(v<1 || v>INT32_MAX) return -2; l.base_sl = (int32_t)v; }
+        else if(!std::strcmp(key,"entry_offset_points")) { if(v<0 || v>INT32_MAX) return -2; l.offset = (int32_t)v; }
+        else if(!std::strcmp(key,"sar_step"))            { if(v<=0 || v>1) return -2; b->col.step[i] = v; }
+        else if(!std::strcmp(key,"sar_max"))             { if(v<=0 || v>1) return -2; b->col.amax[i] = v; }
+        else if(!std::strcmp(key,"level"))               { if(v<1 || v>kMaxLevel) return -2; l.level = (int32_t)v; }
+        else return 0;
+    }
+    return 1;
+}
+
+int32_t batch_on_tick(int32_t id, double bid, double ask, int64_t t){
+    Batch* b = B(id);
+    return b ? tick(*b, bid, ask, t) : -1;
+}
+
+int32_t batch_run(int32_t id, const int64_t* t, const double* bid, const double* ask, int32_t n){
+    Batch* b = B(id);
+    if(!b) return -1;
+    if(!t || !bid || !ask || n<0) return -2;
+    int32_t plans = 0;
+    for(int32_t i=0;i<n;++i) plans += tick(*b, bid[i], ask[i], t[i]);
+    return plans;
+}
+
+int32_t batch_get_lane(int32_t id, int32_t lane, EA_BatchLane* out){
+    const Batch* b = B(id);
+    if(!b) return -1;
+    if(lane<0 || lane>=b->n || !out) return -2;
+    const Lane& l = b->lane[lane];
+    const double sar = b->col.sar[lane];
+    out->sar   = std::isnan(sar) ? 0.0 : sar/b->scale;
+    out->entry = (double)l.entry/b->scale;
+    out->sl    = (double)l.sl/b->scale;
+    for(int32_t j=0;j<3;++j) out->tp[j] = j<l.legs ? (double)l.tp[j]/b->scale : 0.0;
+    out->plans = l.plans;
+    out->last_plan_time = l.last_plan_time;
+    out->dir  = (int32_t)b->col.dir[lane];
+    out->legs = l.legs;
+    return 1;
+}
+
+} // namespace ea
@@ -0,0 +1,26 @@
+#pragma once
+// Batched research engine: N parameter variants of the default strategy on
+// one tick stream. The candle and the EMAs have no per-variant parameter, so
+// they are computed once; each lane's SAR state lives in structure-of-arrays
+// columns advanced by one SIMD kernel per tick (AVX-512, AVX2 or scalar,
+// picked at runtime). Lanes follow the scalar pipeline bit for bit: the
+// kernel uses compares and blends in the scalar operand order, and batch.cpp
+// is compiled with -ffp-contract=off so nothing is fused into an FMA.
+#include <stdint.h>
+#include "ea_api.h"
+
+namespace ea {
+
+static constexpr int32_t kMaxBatches   = 16;
+static constexpr int32_t kMaxBatchLanes = 4096;
+
+// Returns the batch id (1..kMaxBatches), -2 on bad arguments or a full table.
+int32_t batch_create(int32_t lanes, double scale, int32_t isa);
+void    batch_destroy(int32_t id);
+int32_t batch_isa(int32_t id);
+int32_t batch_set_param(int32_t id, int32_t lane, const char* key, double v);
+int32_t batch_on_tick(int32_t id, double bid, double ask, int64_t t);
+int32_t batch_run(int32_t id, const int64_t* t, const double* bid, const double* ask, int32_t n);
+int32_t batch_get_lane(int32_t id, int32_t lane, EA_BatchLane* out);
+
+} // namespace ea
@@ -0,0 +1,105 @@
+#include "execution.h"
+#include <chrono>
+#include <cstring>
+
+namespace ea {
+
+void ExecDist::clear(){
+    n = sum = max = 0;
+    std::memset(bucket, 0, sizeof(bucket));
+}
+
+void ExecDist::record(int64_t v){
+    if(v<0) v = 0;
+    ++n; sum += v;
+    if(v > max) max = v;
+    ++bucket[LatencyHistogram::index_of((uint64_t)v)];
+}
+
+int64_t ExecDist::nth(int64_t rank) const {
+    int64_t seen = 0;
+    for(uint32_t i=0;i<kBuckets;++i){
+        seen += bucket[i];
+        if(seen >= rank){ const int64_t v = (int64_t)LatencyHistogram::upper_of(i); return v < max ? v : max; }
+    }
+    return max;
+}
+
+int32_t ExecTable::find(int32_t level, int32_t qual){
+    for(int32_t i=0;i<n;++i)
+        if(key[i].level==level && key[i].qual==qual) return i;
+    if(n>=kExecKeys) return -1;
+    ExecKey& k = key[n];
+    k.level = level; k.qual = qual;
+    k.place_us.clear(); k.fill_us.clear();
+    k.slip_adverse.clear(); k.slip_favorable.clear();
+    return n++;
+}
+
+int64_t exec_now_us(){
+    return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void exec_record_placed(ExecTable& t, int32_t key, int64_t delay_us){
+    if(key<0) return;
+    t.key[key].place_us.record(delay_us);
+}
+
+void exec_record_filled(ExecTable& t, int32_t key, int64_t slip_points, int64_t fill_us){
+    if(key<0) return;
+    ExecKey& k = t.key[key];
+    if(slip_points<0) k.slip_favorable.record(-slip_points);
+    else              k.slip_adverse.record(slip_points);
+    k.fill_us.record(fill_us);
+}
+
+namespace {
+
+static const double kQ[3] = { 0.5, 0.9, 0.99 };
+
+int64_t rank_of(double q, int64_t n){
+    int64_t r = (int64_t)(q*(double)n + 0.5);
+    return r<1 ? 1 : r;
+}
+
+// Microsecond samples reported in milliseconds.
+void fill_dist(const ExecDist& d, EA_ExecDist& o){
+    o.count = d.n;
+    if(d.n==0){ o.mean = o.p50 = o.p90 = o.p99 = o.worst = 0; return; }
+    double* q[3] = { &o.p50, &o.p90, &o.p99 };
+    for(int32_t i=0;i<3;++i) *q[i] = (double)d.nth(rank_of(kQ[i], d.n))*1e-3;
+    o.mean  = (double)d.sum/(double)d.n*1e-3;
+    o.worst = (double)d.max*1e-3;
+}
+
+// Signed slippage from its two halves: favorable samples are the smallest.
+void fill_slip(const ExecDist& adv, const ExecDist& fav, EA_ExecDist& o){
+    const int64_t n = adv.n + fav.n;
+    o.count = n;
+    if(n==0){ o.mean = o.p50 = o.p90 = o.p99 = o.worst = 0; return; }
+    double* q[3] = { &o.p50, &o.p90, &o.p99 };
+    for(int32_t i=0;i<3;++i){
+        const int64_t r = rank_of(kQ[i], n);
+        *q[i] = r<=fav.n ? -(double)fav.nth(fav.n - r + 1) : (double)adv.nth(r - fav.n);
+    }
+    o.mean  = (double)(adv.sum - fav.sum)/(double)n;
+    o.worst = adv.n ? (double)adv.max : -(double)fav.nth(1);
+}
+
+}
+
+int32_t exec_snapshot(const ExecTable& t, EA_ExecStats* out, int32_t cap){
+    for(int32_t i=0;i<t.n && i<cap;++i){
+        const ExecKey& k = t.key[i];
+        EA_ExecStats& o = out[i];
+        o.level = k.level;
+        o.qualification_code = k.qual;
+        fill_slip(k.slip_adverse, k.slip_favorable, o.slippage_points);
+        fill_dist(k.place_us, o.place_delay_ms);
+        fill_dist(k.fill_us, o.fill_time_ms);
+    }
+    return t.n;
+}
+
+} // namespace ea
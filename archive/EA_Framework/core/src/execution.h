@@ -0,0 +1,50 @@
+#pragma once
+// Execution quality per (level, qualification code): slippage of the fill
+// against the planned entry, plan emission -> EA_OnOrderPlaced delay and
+// EA_OnOrderPlaced -> EA_OnOrderFilled time. Each is a constant-size
+// log-linear histogram (the LatencyHistogram bucketing) plus count, sum and
+// worst, so a context's table never grows. One table per pool slot, allocated
+// on the slot's first use like the M1 history; a key's histograms are cleared
+// when the key is first used, so untouched keys cost no committed memory.
+// Written and read by the context's calling thread only.
+#include <stdint.h>
+#include "ea_api.h"
+#include "latency.h"
+
+namespace ea {
+
+static constexpr int32_t kExecKeys = 40;   // (level, qualification) pairs per context
+
+// Non-negative samples; quantiles are bucket upper bounds capped at the max.
+struct ExecDist {
+    static constexpr uint32_t kBuckets = LatencyHistogram::kBuckets;
+    int64_t  n, sum, max;
+    uint32_t bucket[kBuckets];
+
+    void clear();
+    void record(int64_t v);
+    int64_t nth(int64_t rank) const;   // rank-th smallest sample, 1-based
+};
+
+struct ExecKey {
+    int32_t  level, qual;
+    ExecDist place_us, fill_us;
+    ExecDist slip_adverse, slip_favorable;   // points above / below the planned entry
+};
+
+struct ExecTable {
+    int32_t n;              // keys in use; set to 0 when a context takes the slot
+    ExecKey key[kExecKeys];
+
+    // Index of (level, qual), added on first use; -1 when full (not recorded).
+    int32_t find(int32_t level, int32_t qual);
+};
+
+// Monotonic microseconds for the order-path timestamps.
+int64_t exec_now_us();
+void exec_record_placed(ExecTable& t, int32_t key, int64_t delay_us);
+void exec_record_filled(ExecTable& t, int32_t key, int64_t slip_points, int64_t fill_us);
+// Fills up to cap rows, in order of first use; returns the keys in use.
+int32_t exec_snapshot(const ExecTable& t, EA_ExecStats* out, int32_t cap);
+
+} // namespace ea
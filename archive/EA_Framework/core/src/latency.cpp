@@ -0,0 +1,37 @@
+#include "latency.h"
+
+namespace ea {
+
+namespace {
+struct ClockAnchor {
+    uint64_t cyc;
+    std::chrono::steady_clock::time_point wall;
+};
+const ClockAnchor g_anchor = { cycles(), std::chrono::steady_clock::now() };
+
+#if EA_HAVE_TSC
+double calibrate(){
+    using namespace std::chrono;
+    ClockAnchor a = g_anchor;
+    auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - a.wall).count();
+    if(elapsed < 10000000){ // < 10 ms since load: spin a short fresh window instead
+        a = { cycles(), steady_clock::now() };
+        while(duration_cast<nanoseconds>(steady_clock::now() - a.wall).count() < 5000000) {}
+        elapsed = duration_cast<nanoseconds>(steady_clock::now() - a.wall).count();
+    }
+    uint64_t c = cycles() - a.cyc;
+    return elapsed>0 ? (double)c/(double)elapsed : 1.0;
+}
+#endif
+}
+
+double cycles_per_ns(){
+#if EA_HAVE_TSC
+    static const double cpn = calibrate();   // once per process
+    return cpn;
+#else
+    return 1.0;
+#endif
+}
+
+} // namespace ea
@@ -0,0 +1,139 @@
+#pragma once
+// Latency instrumentation shared by the core: a raw cycle counter and a
+// fixed-size log-linear (HDR-style) histogram. Compile with EA_CORE_STATS=0
+// to remove every timestamp read from the exported calls; EA_CORE_PROFILE=1
+// adds per-stage timers inside EA_OnTick (off by default).
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+  #include <x86intrin.h>
+  #define EA_HAVE_TSC 1
+#else
+  #define EA_HAVE_TSC 0
+#endif
+
+#ifndef EA_CORE_STATS
+#define EA_CORE_STATS 1
+#endif
+#ifndef EA_CORE_PROFILE
+#define EA_CORE_PROFILE 0
+#endif
+
+namespace ea {
+
+// TSC on x86 (one rdtsc), steady_clock nanoseconds elsewhere.
+static inline uint64_t cycles(){
+#if EA_HAVE_TSC
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Cycles per nanosecond, measured once on first use against steady_clock since
+// library load (or over a 5 ms spin if that is under 10 ms) and cached.
+double cycles_per_ns();
+
+// Single-writer counter increment: relaxed load+store, no locked instruction.
+// Other threads may read the counter at any time (relaxed).
+template<class T>
+inline void bump(std::atomic<T>& a, T d = 1){
+    a.store(a.load(std::memory_order_relaxed) + d, std::memory_order_relaxed);
+}
+
+// Log-linear histogram: 8 linear sub-buckets per power of two (<=12.5% error),
+// covering 0 .. 2^34 cycles; larger samples land in the last bucket.
+// Single writer per histogram: counters use relaxed load+store, not RMW, so a
+// record costs no locked instruction; readers may see a slightly stale view.
+struct LatencyHistogram {
+    static constexpr uint32_t kSubBits = 3;
+    static constexpr uint32_t kSub     = 1u<<kSubBits;
+    static constexpr uint32_t kBuckets = 256;
+
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> max{0};
+    std::atomic<uint64_t> bucket[kBuckets] = {};
+
+    static inline uint32_t index_of(uint64_t v){
+        if(v < kSub) return (uint32_t)v;
+        uint32_t msb   = 63u - (uint32_t)__builtin_clzll(v);
+        uint32_t shift = msb - kSubBits;
+        uint32_t idx   = (shift+1)*kSub + (uint32_t)((v >> shift) & (kSub-1));
+        return idx < kBuckets ? idx : kBuckets-1;
+    }
+    // Highest value that maps to bucket idx (HDR "highest equivalent value").
+    static inline uint64_t upper_of(uint32_t idx){
+        if(idx < kSub) return idx;
+        uint32_t shift = idx/kSub - 1;
+        uint64_t low   = (uint64_t)(kSub + idx%kSub) << shift;
+        return low + ((uint64_t)1<<shift) - 1;
+    }
+
+    inline void record(uint64_t v){
+        bump(calls, (uint64_t)1);
+        bump(total, v);
+        if(v > max.load(std::memory_order_relaxed)) max.store(v, std::memory_order_relaxed);
+        bump(bucket[index_of(v)], (uint64_t)1);
+    }
+    void reset(){
+        calls.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+        for(auto& b : bucket) b.store(0, std::memory_order_relaxed);
+    }
+    // Value at quantile q (0..1), in recorded units; 0 when empty.
+    uint64_t quantile(double q) const {
+        uint64_t n = 0;
+        for(const auto& b : bucket) n += b.load(std::memory_order_relaxed);
+        if(n==0) return 0;
+        uint64_t rank = (uint64_t)(q*(double)n + 0.5); if(rank<1) rank=1;
+        uint64_t seen = 0;
+        for(uint32_t i=0;i<kBuckets;++i){
+            seen += bucket[i].load(std::memory_order_relaxed);
+            if(seen >= rank) return upper_of(i);
+        }
+        return upper_of(kBuckets-1);
+    }
+};
+
+// Plain copy of one or more histograms, for aggregation on a cold path.
+struct HistogramSnapshot {
+    uint64_t calls = 0, total = 0, max = 0;
+    uint64_t bucket[LatencyHistogram::kBuckets] = {};
+    void add(const LatencyHistogram& h){
+        calls += h.calls.load(std::memory_order_relaxed);
+        total += h.total.load(std::memory_order_relaxed);
+        uint64_t m = h.max.load(std::memory_order_relaxed); if(m > max) max = m;
+        for(uint32_t i=0;i<LatencyHistogram::kBuckets;++i) bucket[i] += h.bucket[i].load(std::memory_order_relaxed);
+    }
+    // As LatencyHistogram::quantile, capped at the exact max.
+    uint64_t quantile(double q) const {
+        uint64_t n = 0;
+        for(uint64_t b : bucket) n += b;
+        if(n==0) return 0;
+        uint64_t rank = (uint64_t)(q*(double)n + 0.5); if(rank<1) rank=1;
+        uint64_t seen = 0;
+        for(uint32_t i=0;i<LatencyHistogram::kBuckets;++i){
+            seen += bucket[i];
+            if(seen >= rank){ uint64_t v = LatencyHistogram::upper_of(i); return v < max ? v : max; }
+        }
+        return max;
+    }
+};
+
+// Records elapsed cycles into a histogram on stop() or scope exit, whichever
+// comes first. Used for pipeline-stage timers.
+struct ScopedCycles {
+    LatencyHistogram* h;
+    uint64_t t0;
+    explicit ScopedCycles(LatencyHistogram& hist, uint64_t start = cycles()) : h(&hist), t0(start) {}
+    ~ScopedCycles(){ stop(); }
+    inline void stop(){ if(h){ h->record(cycles() - t0); h = nullptr; } }
+    ScopedCycles(const ScopedCycles&) = delete;
+    ScopedCycles& operator=(const ScopedCycles&) = delete;
+};
+
+} // namespace ea
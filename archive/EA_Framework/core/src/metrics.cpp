@@ -0,0 +1,158 @@
+#include "metrics.h"
+
+#if EA_CORE_METRICS
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <cstring>
+#include <cstdio>
+#ifdef _WIN32
+  #include <winsock2.h>
+  #include <ws2tcpip.h>
+  typedef SOCKET sock_t;
+  static const sock_t kBadSock = INVALID_SOCKET;
+  static void sock_close(sock_t s){ closesocket(s); }
+#else
+  #include <sys/socket.h>
+  #include <sys/select.h>
+  #include <netinet/in.h>
+  #include <arpa/inet.h>
+  #include <unistd.h>
+  typedef int sock_t;
+  static const sock_t kBadSock = -1;
+  static void sock_close(sock_t s){ ::close(s); }
+#endif
+#endif
+
+namespace ea {
+
+#if EA_CORE_METRICS
+
+namespace {
+
+struct Server {
+    std::mutex        mtx;      // start/stop only
+    std::thread       th;
+    std::atomic<bool> stop{false};
+    sock_t            listener = kBadSock;
+    int32_t           port = 0;
+
+    ~Server(){
+        // Library unload without EA_MetricsStop: never leave a joinable thread behind.
+        if(!th.joinable()) return;
+        stop.store(true, std::memory_order_relaxed);
+#ifdef _WIN32
+        th.detach();            // joining under the loader lock would deadlock
+#else
+        th.join();
+        sock_close(listener);
+#endif
+    }
+};
+Server g_srv;
+
+// Waits up to ms for s to become readable.
+bool readable(sock_t s, int ms){
+    fd_set rd; FD_ZERO(&rd); FD_SET(s, &rd);
+    timeval tv; tv.tv_sec = ms/1000; tv.tv_usec = (ms%1000)*1000;
+    return select((int)s+1, &rd, nullptr, nullptr, &tv) > 0;
+}
+
+void send_all(sock_t s, const char* p, size_t n){
+    while(n>0){
+        int k = (int)send(s, p, (int)n, 0);
+        if(k<=0) return;
+        p += k; n -= (size_t)k;
+    }
+}
+
+void serve_one(sock_t cl, std::string& body){
+    // Read the request head; only the request line matters.
+    char req[2048]; size_t got = 0;
+    while(got < sizeof(req)-1 && readable(cl, 500)){
+        int k = (int)recv(cl, req+got, (int)(sizeof(req)-1-got), 0);
+        if(k<=0) break;
+        got += (size_t)k; req[got] = '\0';
+        if(std::strstr(req, "\r\n\r\n") || std::strstr(req, "\n\n")) break;
+    }
+    req[got] = '\0';
+
+    const bool is_get = std::strncmp(req, "GET ", 4)==0;
+    const char* path = req+4;
+    const bool ok = is_get && (std::strncmp(path, "/metrics", 8)==0 || std::strncmp(path, "/ ", 2)==0);
+    body.clear();
+    if(ok) render_metrics(body);
+    else   body = "not found\n";
+
+    char head[192];
+    int hn = std::snprintf(head, sizeof(head),
+        "HTTP/1.1 %s\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+        "Content-Length: %zu\r\nConnection: close\r\n\r\n",
+        ok ? "200 OK" : "404 Not Found", body.size());
+    send_all(cl, head, (size_t)hn);
+    send_all(cl, body.data(), body.size());
+}
+
+void run(sock_t ls){
+    std::string body;
+    while(!g_srv.stop.load(std::memory_order_relaxed)){
+        if(!readable(ls, 200)) continue;
+        sock_t cl = accept(ls, nullptr, nullptr);
+        if(cl==kBadSock) continue;
+        serve_one(cl, body);
+        sock_close(cl);
+    }
+}
+
+} // namespace
+
+int32_t metrics_start(int32_t port){
+    std::lock_guard<std::mutex> lk(g_srv.mtx);
+    if(g_srv.th.joinable()) return g_srv.port;
+    if(port<0 || port>65535) return -1;
+#ifdef _WIN32
+    WSADATA wsa;
+    if(WSAStartup(MAKEWORD(2,2), &wsa)!=0) return -1;
+#endif
+    sock_t ls = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if(ls==kBadSock) return -1;
+    int one = 1;
+    setsockopt(ls, SOL_SOCKET, SO_REUSEADDR, (const char*)&one, sizeof(one));
+    sockaddr_in a; std::memset(&a, 0, sizeof(a));
+    a.sin_family = AF_INET;
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);   // localhost only
+    a.sin_port = htons((uint16_t)port);
+    socklen_t alen = sizeof(a);
+    if(bind(ls, (sockaddr*)&a, sizeof(a))!=0 || listen(ls, 8)!=0 ||
+       getsockname(ls, (sockaddr*)&a, &alen)!=0){
+        sock_close(ls);
+        return -1;
+    }
+    g_srv.listener = ls;
+    g_srv.port = ntohs(a.sin_port);
+    g_srv.stop.store(false, std::memory_order_relaxed);
+    g_srv.th = std::thread(run, ls);
+    return g_srv.port;
+}
+
+void metrics_stop(){
+    std::lock_guard<std::mutex> lk(g_srv.mtx);
+    if(!g_srv.th.joinable()) return;
+    g_srv.stop.store(true, std::memory_order_relaxed);
+    g_srv.th.join();
+    sock_close(g_srv.listener);
+    g_srv.listener = kBadSock;
+    g_srv.port = 0;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+#else
+
+int32_t metrics_start(int32_t){ return -1; }
+void metrics_stop(){}
+
+#endif
+
+} // namespace ea
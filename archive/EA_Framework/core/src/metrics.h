@@ -0,0 +1,26 @@
+#pragma once
+// Prometheus text exporter: one background thread serving GET /metrics on
+// 127.0.0.1. The page is rendered from the per-context counters and latency
+// histograms (relaxed reads only), so a scrape never blocks or slows a tick.
+// Compile with EA_CORE_METRICS=0 to drop the socket server (rendering stays).
+#include <stdint.h>
+#include <string>
+
+#ifndef EA_CORE_METRICS
+#define EA_CORE_METRICS 1
+#endif
+
+namespace ea {
+
+// Appends the exposition text for every live context (defined in state.cpp,
+// next to the registry).
+void render_metrics(std::string& out);
+
+// Starts the server on port (0 = ephemeral). Returns the bound port, or -1.
+// Starting while running returns the current port.
+int32_t metrics_start(int32_t port);
+// Stops and joins the server thread. Must be called before the library is
+// unloaded (MT4: OnDeinit of the last chart using it).
+void metrics_stop();
+
+} // namespace ea
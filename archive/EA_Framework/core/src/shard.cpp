@@ -0,0 +1,212 @@
+#include "shard.h"
+#include "latency.h"
+
+#if EA_CORE_SHARDS
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+#endif
+
+namespace ea {
+
+#if EA_CORE_SHARDS
+
+namespace {
+
+static constexpr uint32_t kSpin = 2000;   // empty polls before a worker sleeps
+
+struct alignas(64) Shard {
+    MpscRing<ShardMsg, kShardRing> ring;
+    alignas(64) std::atomic<int64_t> processed{0};   // worker only
+    std::atomic<int64_t> rejected{0};
+    alignas(64) std::atomic<bool> sleeping{false};
+    std::mutex              mtx;
+    std::condition_variable cv;
+    std::thread             th;
+};
+
+struct Engine {
+    std::mutex ctl;                        // start/stop only
+    std::atomic<int32_t> n{0};             // running workers, 0 = stopped
+    std::atomic<int32_t> submitting{0};    // shard_submit calls that may push (see shard_stop)
+    std::atomic<bool>    stop{false};
+    // Allocated on first use and never freed, like the context pool, so a
+    // late submit can't reach freed memory.
+    Shard* shard[kMaxShards] = {};
+    std::atomic<MpscRing<EA_ShardPlan, kPlanRing>*> plans{nullptr};
+    std::atomic<bool>    polling{false};      // plan ring's consumer side is taken
+    std::atomic<int64_t> plans_dropped{0};
+    ~Engine();   // stops running workers at unload
+};
+Engine g_eng;
+
+inline void cpu_relax(){
+#if EA_HAVE_TSC
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+void pin_self(int32_t cpu){
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << (cpu % (int32_t)(8*sizeof(DWORD_PTR))));
+#else
+    cpu_set_t set; CPU_ZERO(&set); CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+bool ready(const Shard& s){
+    const auto& c = s.ring.cell[s.ring.head & (kShardRing-1)];
+    return c.seq.load(std::memory_order_acquire)==s.ring.head+1;
+}
+
+void worker(Shard& s, int32_t cpu){
+    if(cpu>=0) pin_self(cpu);
+    ShardMsg m;
+    uint32_t idle = 0;
+    for(;;){
+        // stop is read before the pop: every push that finished before it was
+        // set is then visible, so the worker never exits over a queued message
+        const bool stopping = g_eng.stop.load(std::memory_order_acquire);
+        if(s.ring.pop(m)){
+            shard_dispatch(m);
+            bump(s.processed);
+            idle = 0;
+            continue;
+        }
+        if(stopping) break;   // ring drained
+        if(++idle < kSpin){ cpu_relax(); continue; }
+        // Sleep until a producer sees `sleeping` after its push (see shard_submit)
+        std::unique_lock<std::mutex> lk(s.mtx);
+        s.sleeping.store(true, std::memory_order_seq_cst);
+        s.cv.wait(lk, [&]{ return ready(s) || g_eng.stop.load(std::memory_order_acquire); });
+        s.sleeping.store(false, std::memory_order_relaxed);
+        idle = 0;
+    }
+}
+
+} // namespace
+
+Engine::~Engine(){
+    // Library unload without EA_ShardStop: never leave a joinable thread behind.
+#ifdef _WIN32
+    // Joining under the loader lock would deadlock: tell the workers to stop
+    // and let them go.
+    std::lock_guard<std::mutex> lk(ctl);
+    const int32_t k = n.exchange(0, std::memory_order_seq_cst);
+    stop.store(true, std::memory_order_release);
+    for(int32_t i=0;i<k;++i){
+        Shard& s = *shard[i];
+        { std::lock_guard<std::mutex> l(s.mtx); s.cv.notify_one(); }
+        s.th.detach();
+    }
+#else
+    shard_stop();
+#endif
+}
+
+int32_t shard_start(int32_t n, bool pin){
+    std::lock_guard<std::mutex> lk(g_eng.ctl);
+    if(const int32_t cur = g_eng.n.load(std::memory_order_relaxed)) return cur;
+    const int32_t cpus = std::max(1, (int32_t)std::thread::hardware_concurrency());
+    if(n<=0) n = cpus;
+    n = std::min(n, kMaxShards);
+    if(!g_eng.plans.load(std::memory_order_relaxed))
+        g_eng.plans.store(new MpscRing<EA_ShardPlan, kPlanRing>(), std::memory_order_release);
+    for(int32_t i=0;i<n;++i) if(!g_eng.shard[i]) g_eng.shard[i] = new Shard();
+    g_eng.stop.store(false, std::memory_order_relaxed);
+    for(int32_t i=0;i<n;++i){
+        Shard& s = *g_eng.shard[i];
+        s.th = std::thread(worker, std::ref(s), pin ? i % cpus : -1);
+    }
+    g_eng.n.store(n, std::memory_order_release);
+    return n;
+}
+
+void shard_stop(){
+    std::lock_guard<std::mutex> lk(g_eng.ctl);
+    const int32_t n = g_eng.n.load(std::memory_order_relaxed);
+    if(!n) return;
+    g_eng.n.store(0, std::memory_order_seq_cst);          // no new submissions
+    // A submitter that saw the engine running may still be pushing; wait for
+    // it so the workers drain its message instead of leaving it for a restart
+    while(g_eng.submitting.load(std::memory_order_seq_cst)) std::this_thread::yield();
+    g_eng.stop.store(true, std::memory_order_release);
+    for(int32_t i=0;i<n;++i){
+        Shard& s = *g_eng.shard[i];
+        { std::lock_guard<std::mutex> l(s.mtx); s.cv.notify_one(); }
+        s.th.join();
+    }
+}
+
+int32_t shard_count(){ return g_eng.n.load(std::memory_order_acquire); }
+
+bool shard_submit(uint32_t key, const ShardMsg& m){
+    // Announced before n is read: shard_stop clears n, then waits for the count
+    g_eng.submitting.fetch_add(1, std::memory_order_seq_cst);
+    const int32_t n = g_eng.n.load(std::memory_order_seq_cst);
+    bool ok = false;
+    if(n){
+        Shard& s = *g_eng.shard[key % (uint32_t)n];
+        ok = s.ring.push(m);
+        if(!ok) s.rejected.fetch_add(1, std::memory_order_relaxed);
+        else {
+            // Pairs with the worker's store of `sleeping` before it re-checks the ring
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(s.sleeping.load(std::memory_order_relaxed)){
+                std::lock_guard<std::mutex> l(s.mtx);
+                s.cv.notify_one();
+            }
+        }
+    }
+    g_eng.submitting.fetch_sub(1, std::memory_order_release);
+    return ok;
+}
+
+bool shard_emit(const EA_ShardPlan& p){
+    if(g_eng.plans.load(std::memory_order_acquire)->push(p)) return true;
+    g_eng.plans_dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// The plan ring has a single consumer: a poll that finds another one in
+// progress reports an empty queue rather than racing it on head.
+bool shard_poll(EA_ShardPlan& p){
+    auto* q = g_eng.plans.load(std::memory_order_acquire);
+    if(!q || g_eng.polling.exchange(true, std::memory_order_acquire)) return false;
+    const bool got = q->pop(p);
+    g_eng.polling.store(false, std::memory_order_release);
+    return got;
+}
+
+void shard_stats(int32_t i, int64_t& submitted, int64_t& rejected, int64_t& processed){
+    const Shard* s = (i>=0 && i<kMaxShards) ? g_eng.shard[i] : nullptr;
+    submitted = s ? (int64_t)s->ring.pushed() : 0;
+    rejected  = s ? s->rejected.load(std::memory_order_relaxed) : 0;
+    processed = s ? s->processed.load(std::memory_order_relaxed) : 0;
+}
+
+int64_t shard_plans_dropped(){ return g_eng.plans_dropped.load(std::memory_order_relaxed); }
+
+#else
+
+int32_t shard_start(int32_t, bool){ return -1; }
+void    shard_stop(){}
+int32_t shard_count(){ return 0; }
+bool    shard_submit(uint32_t, const ShardMsg&){ return false; }
+bool    shard_emit(const EA_ShardPlan&){ return false; }
+bool    shard_poll(EA_ShardPlan&){ return false; }
+void    shard_stats(int32_t, int64_t& s, int64_t& r, int64_t& p){ s = r = p = 0; }
+int64_t shard_plans_dropped(){ return 0; }
+
+#endif
+
+} // namespace ea
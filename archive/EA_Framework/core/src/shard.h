@@ -0,0 +1,92 @@
+#pragma once
+// Sharded engine: N worker threads, each owning the contexts whose symbol
+// hashes to it. Any thread submits ticks and order events into the owning
+// shard's bounded MPSC ring; only that shard's worker ever touches the
+// context, so nothing on a Context is locked. Plans come back through one
+// MPSC ring drained by the terminal (EA_ShardPollPlan).
+// Compile with EA_CORE_SHARDS=0 to drop the threads (the calls then fail).
+#include <stdint.h>
+#include <atomic>
+#include "ea_api.h"
+
+#ifndef EA_CORE_SHARDS
+#define EA_CORE_SHARDS 1
+#endif
+
+namespace ea {
+
+static constexpr int32_t  kMaxShards  = 64;
+static constexpr uint32_t kShardRing  = 1u<<12;  // messages per shard
+static constexpr uint32_t kPlanRing   = 1u<<12;  // plans waiting for EA_ShardPollPlan
+
+// Bounded multi-producer ring (Vyukov): producers claim a cell with one CAS on
+// tail and publish it through the cell's sequence; the single consumer needs
+// no atomic RMW. Cells are consumed in claim order, so one producer's pushes
+// keep their order.
+template<class T, uint32_t N>
+struct MpscRing {
+    static_assert((N & (N-1))==0, "ring size must be a power of two");
+    struct Cell { std::atomic<uint64_t> seq; T v; };
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) uint64_t head = 0;               // consumer only
+    alignas(64) Cell cell[N];
+
+    MpscRing(){ for(uint32_t i=0;i<N;++i) cell[i].seq.store(i, std::memory_order_relaxed); }
+
+    bool push(const T& v){
+        uint64_t pos = tail.load(std::memory_order_relaxed);
+        for(;;){
+            Cell& c = cell[pos & (N-1)];
+            const int64_t d = (int64_t)(c.seq.load(std::memory_order_acquire) - pos);
+            if(d==0){
+                if(tail.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed)){
+                    c.v = v;
+                    c.seq.store(pos+1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(d<0) return false;             // full
+            else pos = tail.load(std::memory_order_relaxed);
+        }
+    }
+    bool pop(T& v){
+        Cell& c = cell[head & (N-1)];
+        if(c.seq.load(std::memory_order_acquire) != head+1) return false;
+        v = c.v;
+        c.seq.store(head+N, std::memory_order_release);
+        ++head;
+        return true;
+    }
+    uint64_t pushed() const { return tail.load(std::memory_order_relaxed); }
+};
+
+enum ShardMsgKind : int32_t { SM_TICK = 0, SM_ORDER_PLACED, SM_ORDER_FILLED, SM_ORDER_CLOSED };
+
+struct ShardMsg {
+    int32_t kind, handle;
+    double  a, b;        // tick: bid, ask; filled: price
+    int64_t t;           // tick: time
+    int32_t i0, i1;      // tick: has_open; orders: EA_ShardSubmitOrder's a, b
+};
+
+// Defined in state.cpp: runs one message on the worker that owns its context.
+void shard_dispatch(const ShardMsg& m);
+
+// Starts n workers (<=0: one per hardware thread, at most kMaxShards), pinned
+// to CPU (i % cpus) when pin is set. Returns the worker count, or -1.
+int32_t shard_start(int32_t n, bool pin);
+// Drains the rings, then stops and joins the workers.
+void    shard_stop();
+int32_t shard_count();
+// Queues m on the shard that owns key (key % running workers); false if its
+// ring is full or the engine is stopped. A message queued here is always run
+// before shard_stop returns.
+bool    shard_submit(uint32_t key, const ShardMsg& m);
+// Plan queue, filled by workers and drained by the terminal. One poll runs at
+// a time; a concurrent one returns false as if the queue were empty.
+bool    shard_emit(const EA_ShardPlan& p);
+bool    shard_poll(EA_ShardPlan& p);
+void    shard_stats(int32_t shard, int64_t& submitted, int64_t& rejected, int64_t& processed);
+int64_t shard_plans_dropped();
+
+} // namespace ea
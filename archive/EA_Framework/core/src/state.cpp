@@ -1,293 +1,1352 @@
 #include <vector>
-#include <string>
-#include <unordered_map>
+#include <new>
+#include <atomic>
 #include <mutex>
 #include <cmath>
+#include <cstring>
+#include <climits>
 #include <algorithm>
 #include "ea_api.h"
+#include "latency.h"
+#include "trace.h"
+#include "metrics.h"
+#include "account.h"
+#include "shard.h"
+#include "strategy.h"
+#include "batch.h"
+#include "execution.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+
+// Prices are held internally as int64 points (price / point). Conversion happens
+// once per input price on entry and once per output on EA_PlanOrderGet.
+// The sentinels (kNoPrice, kNoHigh, kNoLow) live in strategy.h.
 
 struct PlannedOrder {
-    double entry=0, sl=0, tp=0, lots=0.01;
+    int64_t entry=0, sl=0, tp=0; // points
+    double  lots=0.01;
     int32_t qual=LEVEL_1_MAIN;
 };
+static constexpr int32_t kMaxPlan = 8; // max legs per level schema
 
-struct Context {
-    // Broker / symbol
-    std::string symbol = "BTCUSD";
-    int32_t magic = 0;
-    int32_t digits = 5;
+// Hot per-tick state: exactly two cache lines. Line 1 is touched by every tick,
+// line 2 by full-path ticks and candle closes.
+struct alignas(64) HotState {
+    // Last candle close price/time seen (for M1 we approximate by tick time secs), in points
+    int64_t last_minute = -1;
+    int64_t last_close  = kNoPrice;
+    int64_t last_high   = kNoHigh;
+    int64_t last_low    = kNoLow;
+
+    // Indicator state (simple rolling calc, in points)
+    double sar= NAN, sar_ep= NAN, sar_af = 0.001;
+    int32_t sar_dir = 0; // -1 down, +1 up
+    int32_t rb_span = 0; // range-bar mode: bid high - bid low of the forming bar (points, capped)
+
+    double ema_fast = NAN, ema_slow = NAN;
+
+    // Tick conflation (opt-in, Config::conflate): intra-candle ticks that don't
+    // extend the candle extremes, or move less than conflate_points, skip sar_update.
+    int64_t cf_high = kNoHigh, cf_low = kNoLow; // extremes pending for next sar_update
+    int64_t cf_ref2 = kNoPrice;                 // bid+ask at last full-path tick (2x mid)
+    // Read by EA_TickCounters/the metrics exporter from any thread (single writer)
+    std::atomic<int64_t> ticks_full{0}, ticks_conflated{0};
+    int64_t last_open = kNoPrice;               // first tick of the candle (aggregator)
+};
+static_assert(sizeof(HotState)==128, "HotState must stay two cache lines");
+
+// Read-only on the tick path: broker scale, set by EA_Init.
+struct alignas(64) SpecState {
     double  point  = 0.00001;
+    double  scale  = 100000;            // points per price unit, derived once in EA_Init
+    int32_t digits = 5;
+};
+static_assert(sizeof(SpecState)==64, "SpecState must stay one cache line");
 
-    // Fixed client parameters (immutable per spec)
-    const double SAR_step = 0.001;
-    const double SAR_max  = 0.2;
-    // MA config (Fast EMA 1/0, Slow EMA 3/1)
+// Strategy parameters. A published Config is never modified: writers publish
+// a new one (ConfigStore), so a call reads one consistent set.
+struct alignas(64) Config {
     // Golden Candle & entry rules
-    const int    BaseSL_points = 10000;      // also candle size
-    const int    EntryOffset_points = 3500;  // 35% of 10k
+    int32_t BaseSL_points = 10000;      // also candle size
+    int32_t EntryOffset_points = 3500;  // 35% of 10k
+    double  SAR_step = 0.001;
+    double  SAR_max  = 0.2;
+    // MA config (Fast EMA 1/0, Slow EMA 3/1)
+    double  lots = 0.01;                // fixed lots per spec
+    double  conflate_points = 0;
+    int64_t conflate_thr2 = 0;          // ceil(2*conflate_points)
+    int8_t  htf_confirm = 0;            // EA_Timeframe whose SAR must agree with a plan (0 = off)
     // Execution: pending BUY only, 1 trade at a time
-    bool paused = false;
+    bool    paused = false;
+    bool    conflate = false;
+    int32_t range_points = 0;           // signal candles: range bars of this size (0 = M1 time bars)
+    // Latency budgets per call class (ms, <=0 disables), see Watchdog. Off the
+    // tick path: the calling thread copies them into its Watchdog on adoption.
+    alignas(64) double budget_order_ms = 100;   // tick → plan → order callbacks
+    double  budget_ui_ms      = 500;    // everything else
+    double  budget_recover_ms = 1000;   // quiet time before leaving degraded mode
+    bool    degrade_on_overrun = false;
+};
+static_assert(sizeof(Config)==128, "Config must stay two cache lines (strategy, watchdog)");
 
-    // Runtime params (flex)
-    double min_spread_points = 0; // set via EA_SetParamDouble if needed
+// RCU-style publication of a context's Config. The context's calling thread
+// is its only reader: each call takes the current snapshot with one acquire
+// load, first adopting a pending one if a writer published it (one CAS).
+// Writers (any thread, serialized by g_cfg_mtx) fill a slot that is neither
+// current nor pending and publish it as pending. A snapshot the reader has
+// moved off is reclaimed by the next writer, so nothing is rewritten while a
+// call can still see it and nothing is allocated.
+static constexpr uint32_t kNoSlot = 0xFF;
+struct alignas(64) ConfigStore {
+    std::atomic<uint32_t> state{kNoSlot<<8};  // pending slot<<8 | current slot
+    Config slot[3];
+};
 
-    // Indicator state (simple rolling calc)
-    double sar= NAN, sar_ep= NAN, sar_af = SAR_step;
-    int    sar_dir = 0; // -1 down, +1 up
-    double ema_fast = NAN, ema_slow = NAN;
+// Cold state: identity, runtime knobs, plan buffer, diagnostics.
+struct ColdState {
+    // Broker / symbol
+    char    symbol[32] = "BTCUSD";
+    int32_t magic = 0;
+    int32_t handle = 0;
+    uint32_t symbol_hash = 0;   // FNV-1a of symbol: picks the shard
 
-    // Last candle close price/time seen (for M1 we approximate by tick time secs)
-    int64_t last_minute = -1;
-    double  last_close  = NAN;
-    double  last_high   = -INFINITY;
-    double  last_low    =  INFINITY;
+    // Hot-reloaded config file (EA_ConfigLoad / EA_ConfigPoll)
+    char    config_path[260] = "";
+    int64_t config_mtime = -1;
+    int64_t config_size  = -1;
+
+    // Level state (1..25); atomic so the metrics exporter can read it
+    std::atomic<int32_t> level{1};
+    // target hits tracking for SL advisory
+    int32_t targets_hit = 0;
 
     // Plan buffer
-    std::vector<PlannedOrder> plan;
+    int32_t plan_n = 0;
+    PlannedOrder plan[kMaxPlan];
 
-    // Level state (1..25)
-    int level = 1;
-    // target hits tracking for SL advisory
-    int targets_hit = 0;
+    // Execution quality (EA_GetExecStats): when the plan was emitted and at
+    // which level, its legs already placed, and placed orders awaiting a fill
+    int64_t  plan_us = 0;
+    int32_t  plan_level = 0;
+    uint32_t plan_placed = 0;   // bit per plan leg
+    struct PendingOrder { int32_t ticket, key; int64_t entry, placed_us, micro; };
+    PendingOrder pending[kMaxPlan];
+    int32_t  pending_n = 0;
+
+    // Filled tickets still open, and their share of the account exposure
+    int32_t open_tickets[kMaxPlan] = {};
+    int64_t open_leg_micro[kMaxPlan] = {};   // lots * 1e6 of each
+    int32_t open_n = 0;
+    int64_t open_micro = 0;
+    // Unfilled legs of the plan still holding a reservation in g_account
+    int32_t resv_legs = 0;
+    int64_t resv_micro = 0;
+    int32_t active_level = 0;   // level registered in g_account while exposed or reserved
+
+    char last_error[128] = "";
+};
+
+// Monotonic event counters for the metrics exporter. Written by the context's
+// calling thread only (ea::bump), read relaxed by scrapes.
+enum SignalKind { SIG_GOLDEN = 0, SIG_SAR_FLIP, SIG_MA, SIG_COUNT };
+struct alignas(64) Counters {
+    std::atomic<int64_t> signals[SIG_COUNT] = {};
+    std::atomic<int64_t> plans{0};
+    std::atomic<int64_t> errors{0};   // calls rejected for bad arguments
+};
+
+// Signal funnel (EA_GetFunnel) by UTC hour of day; same writer/reader rules
+// as Counters. Totals are summed on export, so an event is a single bump.
+struct alignas(64) Funnel {
+    std::atomic<int64_t> by_hour[24][EA_FUNNEL_COUNT] = {};
+};
 
-    std::string last_error;
+// Latency budget watchdog: every timed call is checked against budget[fn]
+// (cycles). An overrun is counted and, with degrade_on_overrun, puts the
+// context in degraded mode (non-essential work shed) until no overrun has been
+// seen for `recover` cycles. budget, recover and degrade_on_overrun mirror the
+// context's Config (watch_configure). Single writer; atomics are for the exporter.
+struct alignas(64) Watchdog {
+    uint64_t budget[EA_FN_COUNT];      // UINT64_MAX = no budget (until EA_Init)
+    uint64_t recover = 0;
+    uint64_t last_overrun = 0;         // cycles
+    bool     degrade_on_overrun = false;
+    std::atomic<uint32_t> stats_reset{0};     // EA_ResetStats pending (any thread sets it)
+    std::atomic<uint64_t> degraded_since{0};  // cycles, 0 = not degraded
+    std::atomic<uint64_t> degraded_cycles{0}; // closed episodes
+    std::atomic<int64_t>  degraded_entries{0};
+    std::atomic<int32_t>  last_fn{-1};
+    std::atomic<uint64_t> last_cycles{0};
+    std::atomic<int64_t>  overruns[EA_FN_COUNT] = {};
+    Watchdog(){ for(auto& b : budget) b = UINT64_MAX; }
 };
 
-// Global handle registry
+// Multi-timeframe OHLCV bars from bid ticks (EA_GetBars). A tick touches only
+// the forming M1 bar; when a new minute opens, the closed M1 bar is folded into
+// the forming bar of each higher timeframe (O(1) per timeframe), and a higher
+// bar whose period ended is pushed to its ring and steps that timeframe's SAR.
+static constexpr int32_t kBarRing = 64;   // closed bars kept per timeframe (power of 2)
+static constexpr int64_t kTfSeconds[EA_TF_COUNT] = { 60, 300, 900, 3600 };
+
+struct Bar {
+    int64_t time  = -1;                                   // open time, epoch s
+    int64_t open  = kNoPrice, high = kNoHigh, low = kNoLow, close = kNoPrice; // points
+    int64_t ticks = 0;
+};
+struct TfSeries {
+    Bar     forming;                 // open==kNoPrice until its first tick/M1 bar
+    int64_t closed = 0;              // bars pushed so far; ring[(closed-1) % kBarRing] is the newest
+    double  sar = NAN, sar_ep = NAN, sar_af = 0;   // on closed bars, higher timeframes only
+    int32_t sar_dir = 0;
+    Bar     ring[kBarRing];          // higher timeframes; closed M1 bars go to History
+};
+struct alignas(64) Bars {
+    int32_t  spread_min = INT32_MAX, spread_max = 0;   // forming M1 bar, points (same line as it)
+    TfSeries tf[EA_TF_COUNT];
+};
+
+// Completed M1 bars as structure-of-arrays columns, a week deep
+// (EA_HistoryCopy). One per pool slot, allocated when a context first takes the
+// slot and reused by every later one; a closed bar writes one element
+// per column, so lookbacks and copy-outs walk contiguous memory.
+static constexpr int32_t kHistBars = 7*24*60;
+
+struct History {
+    int64_t time[kHistBars];
+    int64_t open[kHistBars], high[kHistBars], low[kHistBars], close[kHistBars]; // points
+    int32_t ticks[kHistBars];
+    int32_t spread_min[kHistBars], spread_max[kHistBars];                        // points
+    int32_t head  = 0;   // next write index
+    int32_t count = 0;   // bars retained, <= kHistBars
+    // Column index of the bar `shift` bars back (0 = newest); shift < count
+    int32_t at(int32_t shift) const { const int32_t i = head-1-shift; return i<0 ? i+kHistBars : i; }
+};
+
+struct alignas(64) Context {
+    HotState  hot;
+    SpecState spec;
+    ConfigStore config;
+    ColdState cold;
+    Counters  counters;
+    Funnel    funnel;
+    Watchdog  watch;
+    Bars      bars;
+    History*  hist = nullptr;   // owned by the pool (g_hist)
+    ea::ExecTable* exec = nullptr;  // owned by the pool (g_exec)
+    // Per exported call latency (EA_GetStats), written by the calling thread only
+    alignas(64) ea::LatencyHistogram stats[EA_FN_COUNT];
+#if EA_CORE_PROFILE
+    // EA_OnTick stage breakdown (EA_GetStageStats)
+    alignas(64) ea::LatencyHistogram stages[EA_STAGE_COUNT];
+#endif
+};
+
+// Times the rest of the enclosing exported call into c->stats[fn] and checks
+// it against the call's latency budget (TimedCall, below)
+#define EA_TIMED(c, fn) TimedCall ea_timed_((c), (fn))
+
+// Stage timers: EA_STAGE times the enclosing scope, EA_STAGE_BEGIN/END a named
+// region, EA_STAGE_MARK/SINCE a region that starts before the context is known.
+#if EA_CORE_PROFILE
+  #define EA_STAGE(c, st)            ea::ScopedCycles ea_stage_##st((c)->stages[st])
+  #define EA_STAGE_BEGIN(c, st, var) ea::ScopedCycles var((c)->stages[st])
+  #define EA_STAGE_END(var)          var.stop()
+  #define EA_STAGE_MARK(var)         const uint64_t var = ea::cycles()
+  #define EA_STAGE_SINCE(c, st, var) ea::ScopedCycles var##_scope((c)->stages[st], var)
+  #define EA_STAGE_RECORD(c, st, var) (c)->stages[st].record(ea::cycles() - var)
+#else
+  #define EA_STAGE(c, st)            do{}while(0)
+  #define EA_STAGE_BEGIN(c, st, var) do{}while(0)
+  #define EA_STAGE_END(var)          do{}while(0)
+  #define EA_STAGE_MARK(var)         do{}while(0)
+  #define EA_STAGE_SINCE(c, st, var) do{}while(0)
+  #define EA_STAGE_RECORD(c, st, var) do{}while(0)
+#endif
+
+// ===== Context pool =====
+// Contexts live in cache-aligned blocks: the first block is preallocated, further
+// blocks are added on demand (cold path) and never released; destroyed slots are
+// recycled. Handles carry a generation so a stale handle can't reach a reused slot.
+static constexpr int32_t kBlockSlots = 64;
+static constexpr int32_t kMaxBlocks  = 128;         // 8192 contexts
+static constexpr int32_t kSlotBits   = 14;
+static constexpr int32_t kSlotMask   = (1<<kSlotBits)-1;
+static constexpr int32_t kGenMask    = (1<<(31-kSlotBits))-1;
+// Handles carry idx+1 (0 is never a handle), so the last slot needs one more value
+static_assert(kMaxBlocks*kBlockSlots <= kSlotMask, "slot index + 1 must fit under kSlotMask");
+
+struct alignas(64) Slot {
+    Context ctx;
+    std::atomic<int32_t> handle{0}; // 0 = free
+};
+struct Block { Slot slots[kBlockSlots]; };
+
 static std::mutex g_mtx;
-static std::unordered_map<int32_t, Context*> g_ctx;
-static int32_t g_next = 1;
+static Block g_block0;
+static std::atomic<Block*> g_blocks[kMaxBlocks] = { {&g_block0} };
+static int32_t g_nblocks = 0; // blocks whose slots have been handed to g_free
+static std::vector<int32_t> g_free;
+static int32_t g_gen = 0;
+// Per slot, allocated on the slot's first use and never released (~0.7 MB
+// together, so a block's worth isn't reserved up front in a 32-bit terminal)
+static History* g_hist[kMaxBlocks*kBlockSlots] = {};
+static ea::ExecTable* g_exec[kMaxBlocks*kBlockSlots] = {};
+
+static Slot* slot_at(int32_t idx){
+    Block* b = g_blocks[idx/kBlockSlots].load(std::memory_order_acquire);
+    return b ? &b->slots[idx%kBlockSlots] : nullptr;
+}
+
+static std::atomic<int64_t> g_bad_handles{0}; // calls with an unknown/stale handle
 
 static Context* G(int32_t h){
-    std::lock_guard<std::mutex> lk(g_mtx);
-    auto it=g_ctx.find(h);
-    return (it==g_ctx.end())?nullptr:it->second;
+    int32_t idx = (h & kSlotMask) - 1;
+    Slot* s = (h>0 && idx>=0 && idx<kMaxBlocks*kBlockSlots) ? slot_at(idx) : nullptr;
+    if(s && s->handle.load(std::memory_order_acquire)==h) return &s->ctx;
+    g_bad_handles.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
 }
 
-// ===== Helpers =====
-static double norm_price(double v, int digits){
-    double p = std::pow(10.0, -digits);
-    return std::round(v/p)*p;
+static void set_text(char* dst, size_t cap, const char* src){
+    std::snprintf(dst, cap, "%s", src);
 }
-static int64_t minute_bucket(int64_t t){ return (t/60)*60; }
 
-// EMA
-static inline double ema_update(double prev, double price, double alpha){
-    if(std::isnan(prev)) return price;
-    return prev + alpha*(price-prev);
+// Rejects a call on a valid context: counts it and records why.
+static int32_t arg_error(Context* c, const char* why, int32_t rc = -1){
+    ea::bump(c->counters.errors);
+    set_text(c->cold.last_error, sizeof(c->cold.last_error), why);
+    return rc;
 }
 
-// Very compact SAR (sufficient for trend & flip detection)
-static void sar_update(Context* c, double high, double low){
-    if(std::isnan(c->sar)){ // init
-        c->sar_dir = +1; // start up by default
-        c->sar_ep  = high;
-        c->sar     = low;
-        c->sar_af  = c->SAR_step;
-        return;
+// ===== Config snapshots =====
+static std::mutex g_cfg_mtx;   // serializes config writers (all contexts)
+
+static void watch_configure(Context* c, const Config& cf);
+
+static uint32_t config_adopt(Context* c, uint32_t s){
+    ConfigStore& cs = c->config;
+    const Config& prev = cs.slot[s & 0xFF];
+    const bool was_conflating = prev.conflate;
+    const double order_ms = prev.budget_order_ms, ui_ms = prev.budget_ui_ms, recover_ms = prev.budget_recover_ms;
+    const bool degrade = prev.degrade_on_overrun;
+    while(!cs.state.compare_exchange_weak(s, (kNoSlot<<8) | (s>>8),
+                                          std::memory_order_acq_rel, std::memory_order_acquire)){}
+    s = (kNoSlot<<8) | (s>>8);
+    const Config& cf = cs.slot[s & 0xFF];
+    if(cf.conflate != was_conflating){   // start conflation from a clean slate
+        HotState& h = c->hot;
+        h.cf_high = kNoHigh; h.cf_low = kNoLow; h.cf_ref2 = kNoPrice;
     }
-    if(c->sar_dir>0){
-        c->sar = c->sar + c->sar_af*(c->sar_ep - c->sar);
-        c->sar = std::min({c->sar, low}); // clamp inside
-        if(high > c->sar_ep){
-            c->sar_ep = high;
-            c->sar_af = std::min(c->sar_af + c->SAR_step, c->SAR_max);
+    if(cf.budget_order_ms!=order_ms || cf.budget_ui_ms!=ui_ms || cf.budget_recover_ms!=recover_ms ||
+       cf.degrade_on_overrun!=degrade)
+        watch_configure(c, cf);
+    return s;
+}
+
+// The calling thread's snapshot. Take it once per call and pass it down.
+static inline const Config& config(Context* c){
+    uint32_t s = c->config.state.load(std::memory_order_acquire);
+    if((s>>8)!=kNoSlot) s = config_adopt(c, s);
+    return c->config.slot[s & 0xFF];
+}
+
+// Publishes a copy of the newest snapshot changed by edit(Config&) -> bool;
+// nothing is published if edit returns false.
+template<class Edit>
+static bool config_update(Context* c, Edit&& edit){
+    std::lock_guard<std::mutex> lk(g_cfg_mtx);
+    ConfigStore& cs = c->config;
+    uint32_t s = cs.state.load(std::memory_order_acquire);
+    const uint32_t cur = s & 0xFF, pend = s>>8;
+    uint32_t idx = 0;
+    while(idx==cur || idx==pend) ++idx;
+    Config& next = cs.slot[idx];
+    next = cs.slot[pend!=kNoSlot ? pend : cur];
+    if(!edit(next)) return false;
+    next.conflate_points = std::max(0.0, next.conflate_points);
+    next.conflate_thr2   = (int64_t)std::ceil(2*next.conflate_points);
+    next.htf_confirm     = (int8_t)std::clamp<int32_t>(next.htf_confirm, 0, EA_TF_COUNT-1);
+    // The reader may adopt the old pending meanwhile; the current slot is then
+    // the one we copied from, never idx.
+    while(!cs.state.compare_exchange_weak(s, (idx<<8) | (s & 0xFF),
+                                          std::memory_order_acq_rel, std::memory_order_acquire)){}
+    return true;
+}
+
+// Applies one strategy key (EA_SetFlag, EA_SetParamDouble, config file).
+// Returns 1, 0 for an unknown key, -1 for an out-of-range value.
+static int32_t config_set(Config& cf, const char* key, double v){
+    if(!std::isfinite(v)) return -1;
+    if(!std::strcmp(key,"paused"))                   cf.paused = (v!=0);
+    else if(!std::strcmp(key,"conflate"))            cf.conflate = (v!=0);
+    else if(!std::strcmp(key,"conflate_points"))     cf.conflate_points = v;
+    else if(!std::strcmp(key,"htf_sar_confirm"))     cf.htf_confirm = (int8_t)std::clamp(v, 0.0, (double)EA_TF_COUNT-1);
+    else if(!std::strcmp(key,"base_sl_points"))      { if(v<1 || v>INT32_MAX) return -1; cf.BaseSL_points = (int32_t)v; }
+    else if(!std::strcmp(key,"entry_offset_points")) { if(v<0 || v>INT32_MAX) return -1; cf.EntryOffset_points = (int32_t)v; }
+    else if(!std::strcmp(key,"sar_step"))            { if(v<=0 || v>1) return -1; cf.SAR_step = v; }
+    else if(!std::strcmp(key,"sar_max"))             { if(v<=0 || v>1) return -1; cf.SAR_max = v; }
+    else if(!std::strcmp(key,"lots"))                { if(v<=0) return -1; cf.lots = v; }
+    else if(!std::strcmp(key,"range_bar_points"))    { if(v<0 || v>INT32_MAX) return -1; cf.range_points = (int32_t)v; }
+    else if(!std::strcmp(key,"budget_order_ms"))     cf.budget_order_ms = v;
+    else if(!std::strcmp(key,"budget_ui_ms"))        cf.budget_ui_ms = v;
+    else if(!std::strcmp(key,"budget_recover_ms"))   cf.budget_recover_ms = v;
+    else if(!std::strcmp(key,"degrade_on_overrun"))  cf.degrade_on_overrun = (v!=0);
+    else return 0;
+    return 1;
+}
+
+// Reads a key=value file ('#' comments, blank lines) into cf. All keys must be
+// known and valid; on failure why names the line and cf is partially written.
+static bool config_parse_file(const char* path, Config& cf, char* why, size_t cap){
+    FILE* f = std::fopen(path, "r");
+    if(!f){ std::snprintf(why, cap, "config: cannot open %s", path); return false; }
+    char line[256];
+    bool ok = true;
+    for(int32_t n=1; ok && std::fgets(line, sizeof(line), f); ++n){
+        char* k = line;
+        while(*k==' ' || *k=='\t') ++k;
+        if(*k=='#' || *k=='\0' || *k=='\n' || *k=='\r') continue;
+        char* eq = std::strchr(k, '=');
+        char* end = nullptr;
+        double v = 0;
+        if(eq){
+            char* e = eq;
+            while(e>k && (e[-1]==' ' || e[-1]=='\t')) --e;
+            *e = '\0';
+            v = std::strtod(eq+1, &end);
+            while(end && (*end==' ' || *end=='\t' || *end=='\r' || *end=='\n')) ++end;
         }
-        if(low < c->sar){ // flip to down
-            c->sar_dir = -1;
-            c->sar     = c->sar_ep;
-            c->sar_ep  = low;
-            c->sar_af  = c->SAR_step;
+        const int32_t rc = (eq && end!=eq+1 && end && *end=='\0') ? config_set(cf, k, v) : -2;
+        if(rc!=1){
+            std::snprintf(why, cap, "config line %d: %s", n, rc==0 ? "unknown key" : rc==-1 ? "value out of range" : "expected key=number");
+            ok = false;
         }
+    }
+    std::fclose(f);
+    return ok;
+}
+
+// Loads path into a new snapshot (all-or-nothing) and remembers it for EA_ConfigPoll.
+static int32_t config_load(Context* c, const char* path, int64_t mtime, int64_t size){
+    char why[128] = "";
+    const bool ok = config_update(c, [&](Config& cf){ return config_parse_file(path, cf, why, sizeof(why)); });
+    ColdState& cs = c->cold;
+    if(path!=cs.config_path) set_text(cs.config_path, sizeof(cs.config_path), path);
+    cs.config_mtime = mtime; cs.config_size = size;
+    return ok ? 1 : arg_error(c, why, -2);
+}
+
+// ===== Helpers =====
+static double points_scale(int32_t digits, double point){
+    if(point>0 && point<=1) return std::round(1.0/point);
+    return std::pow(10.0, std::max(0, digits));
+}
+// Round to whole points (current rounding mode, i.e. half-to-even). Kept as a
+// double where the caller feeds double math, so no int round trip is paid.
+static inline double round_points(double px, double scale){ return std::rint(px*scale); }
+static inline int64_t to_points(double px, double scale){ return (int64_t)round_points(px, scale); }
+// Nearest double to pts/scale: the exact normalized price, no drift
+static inline double to_price(int64_t pts, double scale){ return (double)pts/scale; }
+static int64_t minute_bucket(int64_t t){ return (t/60)*60; }
+
+static inline void funnel_count(Context* c, int64_t t, int32_t gate){
+    ea::bump(c->funnel.by_hour[(uint64_t)(t/3600) % 24][gate]);
+}
+
+static void sar_update(Context* c, const Config& cf, int64_t high, int64_t low){
+    HotState& h = c->hot;
+    ea::sar_step(h.sar, h.sar_ep, h.sar_af, h.sar_dir, cf.SAR_step, cf.SAR_max, (double)high, (double)low);
+}
+
+// ===== Multi-timeframe bars =====
+static inline int64_t tf_bucket(int64_t t, int32_t tf){ return (t/kTfSeconds[tf])*kTfSeconds[tf]; }
+
+static inline void bar_fold(Bar& dst, const Bar& b){
+    if(dst.open==kNoPrice) dst.open = b.open;
+    dst.high  = std::max(dst.high, b.high);
+    dst.low   = std::min(dst.low,  b.low);
+    dst.close = b.close;
+    dst.ticks += b.ticks;
+}
+
+// Pushes the forming bar of tf (if it has data) to the ring and clears it.
+static void bars_close(Context* c, const Config& cf, int32_t tf){
+    TfSeries& s = c->bars.tf[tf];
+    if(s.forming.open==kNoPrice) return;
+    if(tf==EA_TF_M1){
+        History& hs = *c->hist;
+        const int32_t i = hs.head;
+        hs.time[i]  = s.forming.time;
+        hs.open[i]  = s.forming.open;  hs.high[i]  = s.forming.high;
+        hs.low[i]   = s.forming.low;   hs.close[i] = s.forming.close;
+        hs.ticks[i] = (int32_t)std::min<int64_t>(s.forming.ticks, INT32_MAX);
+        hs.spread_min[i] = c->bars.spread_min==INT32_MAX ? 0 : c->bars.spread_min;
+        hs.spread_max[i] = c->bars.spread_max;
+        hs.head  = i+1==kHistBars ? 0 : i+1;
+        hs.count = std::min(hs.count+1, kHistBars);
+        ++s.closed;
+        c->bars.spread_min = INT32_MAX; c->bars.spread_max = 0;
     } else {
-        c->sar = c->sar + c->sar_af*(c->sar_ep - c->sar);
-        c->sar = std::max({c->sar, high});
-        if(low < c->sar_ep){
-            c->sar_ep = low;
-            c->sar_af = std::min(c->sar_af + c->SAR_step, c->SAR_max);
+        s.ring[s.closed++ & (kBarRing-1)] = s.forming;
+        ea::sar_step(s.sar, s.sar_ep, s.sar_af, s.sar_dir, cf.SAR_step, cf.SAR_max,
+                 (double)s.forming.high, (double)s.forming.low);
+    }
+    s.forming = Bar{};
+}
+
+// A new M1 bar opens at mb: close the forming M1 bar, fold it into every higher
+// timeframe, and close the higher bars whose period ends before mb.
+static void bars_roll(Context* c, const Config& cf, int64_t mb){
+    TfSeries* tf = c->bars.tf;
+    const Bar m1 = tf[EA_TF_M1].forming;
+    bars_close(c, cf, EA_TF_M1);
+    for(int32_t i=EA_TF_M1+1;i<EA_TF_COUNT;++i){
+        TfSeries& s = tf[i];
+        if(m1.open!=kNoPrice){
+            const int64_t b = tf_bucket(m1.time, i);
+            if(s.forming.time!=b){ bars_close(c, cf, i); s.forming.time = b; }
+            bar_fold(s.forming, m1);
+        }
+        const int64_t nb = tf_bucket(mb, i);
+        if(s.forming.time!=nb){ bars_close(c, cf, i); s.forming.time = nb; }
+    }
+    tf[EA_TF_M1].forming.time = mb;
+}
+
+static inline void bars_tick(Context* c, const Config& cf, int64_t bid, int64_t ask, int64_t mb){
+    Bars& bs = c->bars;
+    Bar& b = bs.tf[EA_TF_M1].forming;
+    if(mb!=b.time) bars_roll(c, cf, mb);
+    if(b.open==kNoPrice) b.open = bid;
+    b.high  = std::max(b.high, bid);
+    b.low   = std::min(b.low,  bid);
+    b.close = bid;
+    ++b.ticks;
+    const int32_t spread = (int32_t)std::clamp<int64_t>(ask-bid, 0, INT32_MAX);
+    bs.spread_min = std::min(bs.spread_min, spread);
+    bs.spread_max = std::max(bs.spread_max, spread);
+}
+
+// Bar `shift` of tf, newest first; 0 is the forming bar (higher timeframes
+// merge in the forming M1 bar). False past the retained history.
+static bool bars_get(const Context* c, int32_t tf, int32_t shift, Bar& out){
+    const TfSeries& s = c->bars.tf[tf];
+    out = s.forming;
+    if(tf!=EA_TF_M1){
+        const Bar& m1 = c->bars.tf[EA_TF_M1].forming;
+        if(m1.open!=kNoPrice && tf_bucket(m1.time, tf)==out.time) bar_fold(out, m1);
+    }
+    if(out.open!=kNoPrice){
+        if(shift==0) return true;
+        --shift;
+    }
+    if(tf==EA_TF_M1){
+        const History& hs = *c->hist;
+        if(shift>=hs.count) return false;
+        const int32_t i = hs.at(shift);
+        out.time = hs.time[i];
+        out.open = hs.open[i]; out.high = hs.high[i]; out.low = hs.low[i]; out.close = hs.close[i];
+        out.ticks = hs.ticks[i];
+        return true;
+    }
+    const int64_t kept = std::min<int64_t>(s.closed, kBarRing);
+    if(shift>=kept) return false;
+    out = s.ring[(s.closed-1-shift) & (kBarRing-1)];
+    return true;
+}
+
+// Higher-timeframe SAR confirmation ("htf_sar_confirm"): that timeframe's SAR
+// must be rising and under the signal close.
+static inline bool htf_confirms(const Context* c, const Config& cf, int64_t close){
+    const int32_t tf = cf.htf_confirm;
+    if(tf<=EA_TF_M1) return true;
+    const TfSeries& s = c->bars.tf[tf];
+    return s.sar_dir>0 && s.sar < (double)close;
+}
+
+// MA up arrow (fast EMA close above the slow EMA of the candle before)
+template<class Ma>
+static inline bool ma_up_signal(HotState& h, int64_t close, double prev_slow){
+    Ma::update(h.ema_fast, h.ema_slow, (double)close);
+    return h.ema_fast > prev_slow;
+}
+
+static void reset_indicators(Context* c){
+    HotState& h = c->hot;
+    h.sar = NAN; h.ema_fast=NAN; h.ema_slow=NAN;
+    h.cf_high=kNoHigh; h.cf_low=kNoLow; h.cf_ref2=kNoPrice; h.rb_span=0;
+    for(TfSeries& s : c->bars.tf) s = TfSeries{};
+    c->bars.spread_min = INT32_MAX; c->bars.spread_max = 0;
+    c->hist->head = c->hist->count = 0;
+    c->cold.plan_n = 0;
+    c->cold.last_error[0] = '\0';
+}
+
+// ===== Metrics exposition (Prometheus text format) =====
+// Walks the pool without taking g_mtx: blocks are never freed, and every field
+// read here is a relaxed atomic, so a scrape can't stall or corrupt a tick.
+// A context being recycled concurrently may contribute a partial view once.
+static const char* const kFnName[EA_FN_COUNT] = {
+    "init", "reset", "warmup", "on_tick", "plan_orders_count", "plan_order_get",
+    "order_placed", "order_filled", "order_closed", "current_level", "apply_level",
+    "advise_sl", "set_flag", "set_param", "tick_counters", "last_error",
+};
+static const char* const kSignalName[SIG_COUNT] = { "golden_candle", "sar_flip", "ma_cross" };
+static const char* const kFunnelName[EA_FUNNEL_COUNT] = {
+    "paused", "in_position", "candles", "sar_up", "ma_up",
+    "not_golden", "no_trigger", "htf_veto", "risk_veto", "planned",
+};
+
+static void appendf(std::string& out, const char* fmt, ...){
+    char buf[256];
+    va_list ap; va_start(ap, fmt);
+    int n = std::vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if(n>0) out.append(buf, (size_t)std::min(n, (int)sizeof(buf)-1));
+}
+
+namespace ea {
+void render_metrics(std::string& out){
+    int64_t contexts=0, full=0, conflated=0, plans=0, arg_errors=0, degraded=0;
+    uint64_t degraded_cycles=0;
+    const uint64_t now = cycles();
+    int64_t overruns[EA_FN_COUNT] = {};
+    int64_t signals[SIG_COUNT] = {};
+    int64_t funnel[EA_FUNNEL_COUNT] = {};
+    int64_t by_level[26] = {};
+    std::vector<HistogramSnapshot> lat(EA_FN_COUNT);
+    for(int32_t b=0;b<kMaxBlocks;++b){
+        Block* blk = g_blocks[b].load(std::memory_order_acquire);
+        if(!blk) break;
+        for(Slot& s : blk->slots){
+            if(s.handle.load(std::memory_order_acquire)==0) continue;
+            const Context& c = s.ctx;
+            ++contexts;
+            full      += c.hot.ticks_full.load(std::memory_order_relaxed);
+            conflated += c.hot.ticks_conflated.load(std::memory_order_relaxed);
+            plans     += c.counters.plans.load(std::memory_order_relaxed);
+            arg_errors+= c.counters.errors.load(std::memory_order_relaxed);
+            for(int32_t k=0;k<SIG_COUNT;++k) signals[k] += c.counters.signals[k].load(std::memory_order_relaxed);
+            for(const auto& row : c.funnel.by_hour)
+                for(int32_t g=0;g<EA_FUNNEL_COUNT;++g) funnel[g] += row[g].load(std::memory_order_relaxed);
+            ++by_level[std::clamp(c.cold.level.load(std::memory_order_relaxed), 1, 25)];
+            for(int32_t f=0;f<EA_FN_COUNT;++f) lat[f].add(c.stats[f]);
+            for(int32_t f=0;f<EA_FN_COUNT;++f) overruns[f] += c.watch.overruns[f].load(std::memory_order_relaxed);
+            degraded_cycles += c.watch.degraded_cycles.load(std::memory_order_relaxed);
+            const uint64_t since = c.watch.degraded_since.load(std::memory_order_relaxed);
+            if(since){ ++degraded; if(now > since) degraded_cycles += now - since; }
         }
-        if(high > c->sar){
-            c->sar_dir = +1;
-            c->sar     = c->sar_ep;
-            c->sar_ep  = high;
-            c->sar_af  = c->SAR_step;
+    }
+
+    out += "# HELP ea_contexts Live contexts in the registry.\n# TYPE ea_contexts gauge\n";
+    appendf(out, "ea_contexts %lld\n", (long long)contexts);
+    out += "# HELP ea_ticks_total Ticks processed, by path.\n# TYPE ea_ticks_total counter\n";
+    appendf(out, "ea_ticks_total{path=\"full\"} %lld\n", (long long)full);
+    appendf(out, "ea_ticks_total{path=\"conflated\"} %lld\n", (long long)conflated);
+    out += "# HELP ea_signals_total Entry signals seen at candle close, by type.\n# TYPE ea_signals_total counter\n";
+    for(int32_t k=0;k<SIG_COUNT;++k)
+        appendf(out, "ea_signals_total{type=\"%s\"} %lld\n", kSignalName[k], (long long)signals[k]);
+    out += "# HELP ea_funnel_total Candle closes by the entry gate they stopped at, and dropped ticks.\n# TYPE ea_funnel_total counter\n";
+    for(int32_t g=0;g<EA_FUNNEL_COUNT;++g)
+        appendf(out, "ea_funnel_total{gate=\"%s\"} %lld\n", kFunnelName[g], (long long)funnel[g]);
+    out += "# HELP ea_plans_total Order plans emitted.\n# TYPE ea_plans_total counter\n";
+    appendf(out, "ea_plans_total %lld\n", (long long)plans);
+    out += "# HELP ea_contexts_by_level Contexts currently at each level.\n# TYPE ea_contexts_by_level gauge\n";
+    for(int32_t l=1;l<=25;++l)
+        if(by_level[l]) appendf(out, "ea_contexts_by_level{level=\"%d\"} %lld\n", l, (long long)by_level[l]);
+    EA_AccountRisk acct;
+    account_snapshot(&acct);
+    static const char* const kVetoName[EA_RISK_COUNT] = { "none", "kill_switch", "daily_loss", "exposure", "high_level" };
+    out += "# HELP ea_kill_switch Global kill switch state.\n# TYPE ea_kill_switch gauge\n";
+    appendf(out, "ea_kill_switch %d\n", acct.kill_switch);
+    out += "# HELP ea_account_open_lots Filled lots across contexts.\n# TYPE ea_account_open_lots gauge\n";
+    appendf(out, "ea_account_open_lots %.6f\n", acct.open_lots);
+    out += "# HELP ea_account_daily_pnl Realized P&L of the current UTC day.\n# TYPE ea_account_daily_pnl gauge\n";
+    appendf(out, "ea_account_daily_pnl %.2f\n", acct.daily_pnl);
+    out += "# HELP ea_plan_vetoes_total Plans not emitted because of an account limit.\n# TYPE ea_plan_vetoes_total counter\n";
+    for(int32_t k=1;k<EA_RISK_COUNT;++k)
+        appendf(out, "ea_plan_vetoes_total{reason=\"%s\"} %lld\n", kVetoName[k], (long long)acct.vetoes[k]);
+    if(const int32_t shards = shard_count()){
+        out += "# HELP ea_shard_messages_total Sharded engine messages per shard, by outcome.\n# TYPE ea_shard_messages_total counter\n";
+        for(int32_t i=0;i<shards;++i){
+            int64_t sub=0, rej=0, done=0;
+            shard_stats(i, sub, rej, done);
+            appendf(out, "ea_shard_messages_total{shard=\"%d\",outcome=\"queued\"} %lld\n", i, (long long)sub);
+            appendf(out, "ea_shard_messages_total{shard=\"%d\",outcome=\"rejected\"} %lld\n", i, (long long)rej);
+            appendf(out, "ea_shard_messages_total{shard=\"%d\",outcome=\"processed\"} %lld\n", i, (long long)done);
         }
+        out += "# HELP ea_shard_plans_dropped_total Plans lost because the plan queue was full.\n# TYPE ea_shard_plans_dropped_total counter\n";
+        appendf(out, "ea_shard_plans_dropped_total %lld\n", (long long)shard_plans_dropped());
+    }
+    out += "# HELP ea_errors_total Rejected calls.\n# TYPE ea_errors_total counter\n";
+    appendf(out, "ea_errors_total{kind=\"invalid_handle\"} %lld\n", (long long)g_bad_handles.load(std::memory_order_relaxed));
+    appendf(out, "ea_errors_total{kind=\"invalid_argument\"} %lld\n", (long long)arg_errors);
+#if EA_CORE_STATS
+    const double sec_per_cycle = 1e-9/cycles_per_ns();
+    out += "# HELP ea_budget_overruns_total Calls over their latency budget.\n# TYPE ea_budget_overruns_total counter\n";
+    for(int32_t f=0;f<EA_FN_COUNT;++f)
+        if(overruns[f]) appendf(out, "ea_budget_overruns_total{fn=\"%s\"} %lld\n", kFnName[f], (long long)overruns[f]);
+    out += "# HELP ea_degraded_contexts Contexts currently in degraded mode.\n# TYPE ea_degraded_contexts gauge\n";
+    appendf(out, "ea_degraded_contexts %lld\n", (long long)degraded);
+    out += "# HELP ea_degraded_seconds_total Time spent in degraded mode, all contexts.\n# TYPE ea_degraded_seconds_total counter\n";
+    appendf(out, "ea_degraded_seconds_total %.6f\n", (double)degraded_cycles*sec_per_cycle);
+    if(degraded) return;   // shed: the latency summary is the expensive part of a scrape
+    out += "# HELP ea_call_latency_seconds Exported call latency across all contexts.\n# TYPE ea_call_latency_seconds summary\n";
+    static const double kQ[] = { 0.5, 0.9, 0.99, 0.999 };
+    for(int32_t f=0;f<EA_FN_COUNT;++f){
+        const HistogramSnapshot& h = lat[f];
+        if(h.calls==0) continue;
+        for(double q : kQ)
+            appendf(out, "ea_call_latency_seconds{fn=\"%s\",quantile=\"%g\"} %.9g\n",
+                    kFnName[f], q, (double)h.quantile(q)*sec_per_cycle);
+        appendf(out, "ea_call_latency_seconds_sum{fn=\"%s\"} %.9g\n", kFnName[f], (double)h.total*sec_per_cycle);
+        appendf(out, "ea_call_latency_seconds_count{fn=\"%s\"} %llu\n", kFnName[f], (unsigned long long)h.calls);
+    }
+#endif
+}
+} // namespace ea
+
+// ===== Account exposure =====
+// A context adds its filled legs to g_account at their own lots and registers
+// its level while it has any open; closes (and context destruction) give them
+// back. A plan emitted under a limit has already reserved its legs
+// (account_veto): a fill takes its leg's share over, a cancel returns it, and
+// so do the unplaced legs at the next evaluated close and the rest at the
+// next plan.
+static void exposure_settle(Context* c){
+    ColdState& cs = c->cold;
+    if(cs.open_n==0 && cs.resv_legs==0 && cs.active_level){
+        ea::g_account.active_by_level[cs.active_level].fetch_sub(1, std::memory_order_relaxed);
+        cs.active_level = 0;
+    }
+}
+// Drops the reservation of n_legs legs; returns their micro-lots, which the
+// caller moves to a fill or gives back to g_account.
+static int64_t exposure_unreserve(Context* c, int32_t n_legs){
+    ColdState& cs = c->cold;
+    n_legs = std::min(n_legs, cs.resv_legs);
+    if(n_legs<=0) return 0;
+    const int64_t give = n_legs==cs.resv_legs ? cs.resv_micro : cs.resv_micro/cs.resv_legs*n_legs;
+    cs.resv_legs -= n_legs;
+    cs.resv_micro -= give;
+    return give;
+}
+static void exposure_give_back(Context* c, int32_t n_legs){
+    ea::g_account.open_micro.v.fetch_sub(exposure_unreserve(c, n_legs), std::memory_order_relaxed);
+    exposure_settle(c);
+}
+static void exposure_fill(Context* c, int32_t ticket){
+    ColdState& cs = c->cold;
+    if(cs.open_n>=kMaxPlan) return;
+    // The leg's own lots: a placed leg's, else the plan's, else the config's
+    int64_t micro = -1;
+    for(int32_t i=0;i<cs.pending_n;++i) if(cs.pending[i].ticket==ticket){ micro = cs.pending[i].micro; break; }
+    const int64_t held = micro>=0 ? exposure_unreserve(c, 1) : 0;
+    if(micro<0) micro = ea::lots_to_micro(cs.plan_n ? cs.plan[0].lots : config(c).lots);
+    if(cs.active_level==0){
+        cs.active_level = std::clamp(cs.level.load(std::memory_order_relaxed), 1, ea::kMaxLevel);
+        ea::g_account.active_by_level[cs.active_level].fetch_add(1, std::memory_order_relaxed);
+    }
+    cs.open_tickets[cs.open_n] = ticket;
+    cs.open_leg_micro[cs.open_n++] = micro;
+    cs.open_micro += micro;
+    ea::g_account.open_micro.v.fetch_add(micro - held, std::memory_order_relaxed);
+}
+static void exposure_close(Context* c, int32_t ticket){
+    ColdState& cs = c->cold;
+    for(int32_t i=0;i<cs.open_n;++i){
+        if(cs.open_tickets[i]!=ticket) continue;
+        const int64_t give = cs.open_leg_micro[i];
+        --cs.open_n;
+        cs.open_tickets[i] = cs.open_tickets[cs.open_n];
+        cs.open_leg_micro[i] = cs.open_leg_micro[cs.open_n];
+        cs.open_micro -= give;
+        ea::g_account.open_micro.v.fetch_sub(give, std::memory_order_relaxed);
+        exposure_settle(c);
+        return;
     }
+    for(int32_t i=0;i<cs.pending_n;++i)   // a placed leg cancelled or expired
+        if(cs.pending[i].ticket==ticket){ exposure_give_back(c, 1); return; }
+}
+static void exposure_release_all(Context* c){
+    ColdState& cs = c->cold;
+    ea::g_account.open_micro.v.fetch_sub(cs.open_micro + exposure_unreserve(c, cs.resv_legs), std::memory_order_relaxed);
+    cs.open_n = 0;
+    cs.open_micro = 0;
+    exposure_settle(c);
 }
 
-// Level → RR schema (fixed, per spec)
-static void level_rr_schema(int level, std::vector<double>& rr, std::vector<int32_t>& quals){
-    rr.clear(); quals.clear();
-    if(level>=1 && level<=6){
-        rr.push_back( (double)(level+1) ); // Level1=2,2=3,...,6=7
-        quals.push_back(LEVEL_1_MAIN);
+// ===== Execution quality =====
+// A placement takes the first unplaced leg of the current plan with its
+// qualification code; the resulting pending order is matched to its fill by
+// ticket. Callbacks that match nothing are not recorded.
+static void exec_placed(Context* c, int32_t ticket, int32_t qual){
+    ColdState& cs = c->cold;
+    for(int32_t i=0;i<cs.plan_n;++i){
+        if(cs.plan[i].qual!=qual || (cs.plan_placed>>i & 1u)) continue;
+        cs.plan_placed |= 1u<<i;
+        const int64_t now = ea::exec_now_us();
+        const int32_t key = c->exec->find(cs.plan_level, qual);
+        ea::exec_record_placed(*c->exec, key, now - cs.plan_us);
+        if(cs.pending_n<kMaxPlan)
+            cs.pending[cs.pending_n++] = { ticket, key, cs.plan[i].entry, now, ea::lots_to_micro(cs.plan[i].lots) };
+        return;
+    }
+}
+static void exec_forget(Context* c, int32_t ticket){
+    ColdState& cs = c->cold;
+    for(int32_t i=0;i<cs.pending_n;++i)
+        if(cs.pending[i].ticket==ticket){ cs.pending[i] = cs.pending[--cs.pending_n]; return; }
+}
+static void exec_filled(Context* c, int32_t ticket, double fill_price){
+    ColdState& cs = c->cold;
+    for(int32_t i=0;i<cs.pending_n;++i){
+        const ColdState::PendingOrder& p = cs.pending[i];
+        if(p.ticket!=ticket) continue;
+        if(std::isfinite(fill_price))
+            ea::exec_record_filled(*c->exec, p.key, to_points(fill_price, c->spec.scale) - p.entry,
+                                   ea::exec_now_us() - p.placed_us);
+        cs.pending[i] = cs.pending[--cs.pending_n];
         return;
     }
-    // 7..12 examples per spec. Extend similarly up to 25 as needed.
-    switch(level){
-        case 7:  rr={1,7};    quals={LEVEL_7_FIRST,LEVEL_7_SECOND}; break;
-        case 8:  rr={3,7};    quals={LEVEL_8_FIRST,LEVEL_8_SECOND}; break;
-        case 9:  rr={5,7};    quals={LEVEL_9_FIRST,LEVEL_9_SECOND}; break;
-        case 10: rr={7,7};    quals={LEVEL_10_FIRST,LEVEL_10_SECOND}; break;
-        case 11: rr={3,7,7};  quals={LEVEL_11_FIRST,LEVEL_11_SECOND,LEVEL_11_THIRD}; break;
-        case 12: rr={5,7,7};  quals={LEVEL_12_FIRST,LEVEL_12_SECOND,LEVEL_12_THIRD}; break;
-        default: rr={2};      quals={LEVEL_1_MAIN}; break; // fallback
+}
+
+// ===== Latency budget watchdog =====
+// Calls on the order path (tick → plan → order callbacks) get the order
+// budget, the rest the UI budget.
+static constexpr bool kOrderPath[EA_FN_COUNT] = {
+    false, false, false, true,  true,  true,   // init reset warmup on_tick plan_count plan_get
+    true,  true,  true,  false, false, true,   // placed filled closed current_level apply_level advise_sl
+    false, false, false, false,                // set_flag set_param tick_counters last_error
+};
+
+static uint64_t ms_to_cycles(double ms, double cpn){
+    return ms>0 ? (uint64_t)(ms*1e6*cpn) : UINT64_MAX;
+}
+static void leave_degraded(Context* c, uint64_t now);
+
+// Copies cf's watchdog knobs into the Watchdog (calling thread: EA_Init and
+// snapshot adoption). Turning degrade_on_overrun off leaves degraded mode.
+static void watch_configure(Context* c, const Config& cf){
+    Watchdog& w = c->watch;
+    const double cpn = ea::cycles_per_ns();
+    for(int32_t f=0;f<EA_FN_COUNT;++f)
+        w.budget[f] = ms_to_cycles(kOrderPath[f] ? cf.budget_order_ms : cf.budget_ui_ms, cpn);
+    w.recover = (uint64_t)(std::max(0.0, cf.budget_recover_ms)*1e6*cpn);
+    w.degrade_on_overrun = cf.degrade_on_overrun;
+    if(!w.degrade_on_overrun) leave_degraded(c, ea::cycles());
+}
+
+static void leave_degraded(Context* c, uint64_t now){
+    Watchdog& w = c->watch;
+    const uint64_t since = w.degraded_since.load(std::memory_order_relaxed);
+    if(!since) return;
+    ea::bump(w.degraded_cycles, now - since);
+    w.degraded_since.store(0, std::memory_order_relaxed);
+#if EA_CORE_TRACE
+    ea::trace_shed(false);
+#endif
+}
+
+#if EA_CORE_STATS
+static void budget_overrun(Context* c, int32_t fn, uint64_t t0, uint64_t t1){
+    Watchdog& w = c->watch;
+    ea::bump(w.overruns[fn]);
+    w.last_fn.store(fn, std::memory_order_relaxed);
+    w.last_cycles.store(t1 - t0, std::memory_order_relaxed);
+    w.last_overrun = t1;
+#if EA_CORE_TRACE
+    if(ea::trace_enabled()) ea::trace_record(ea::TR_OVERRUN, c->cold.handle, fn, t0, t1);
+#endif
+    if(w.degrade_on_overrun && !w.degraded_since.load(std::memory_order_relaxed)){
+        w.degraded_since.store(t1, std::memory_order_relaxed);
+        ea::bump(w.degraded_entries);
+#if EA_CORE_TRACE
+        ea::trace_shed(true);
+#endif
     }
 }
+#endif
+
+// The histograms have a single writer (the context's calling thread), so
+// EA_ResetStats only flags the request; the writer clears them at its next
+// timed call, before recording it.
+static inline void stats_reset_poll(Context* c){
+    if(!c->watch.stats_reset.load(std::memory_order_relaxed)) return;
+    c->watch.stats_reset.store(0, std::memory_order_relaxed);
+    for(auto& hs : c->stats) hs.reset();
+#if EA_CORE_PROFILE
+    for(auto& hs : c->stages) hs.reset();
+#endif
+}
+
+// One TSC read pair per exported call: start on construction, record and check
+// the budget on exit. Compiled out (with the watchdog) when EA_CORE_STATS=0.
+// Adopts a pending Config first, so new budgets apply from this call on.
+struct TimedCall {
+#if EA_CORE_STATS
+    Context* c;
+    int32_t  fn;
+    uint64_t t0;
+    TimedCall(Context* ctx, int32_t f) : c(ctx), fn(f), t0(ea::cycles()) { stats_reset_poll(c); config(c); }
+    ~TimedCall(){
+        const uint64_t t1 = ea::cycles(), d = t1 - t0;
+        c->stats[fn].record(d);
+        Watchdog& w = c->watch;
+        if(d > w.budget[fn]) budget_overrun(c, fn, t0, t1);
+        else if(w.degraded_since.load(std::memory_order_relaxed) && t1 - w.last_overrun >= w.recover)
+            leave_degraded(c, t1);
+    }
+#elif EA_CORE_PROFILE
+    TimedCall(Context* c, int32_t) { stats_reset_poll(c); }   // stage histograms only
+#else
+    TimedCall(Context*, int32_t) {}
+#endif
+    TimedCall(const TimedCall&) = delete;
+    TimedCall& operator=(const TimedCall&) = delete;
+};
 
-// Validate Golden Candle (size ≥ 10k points) with equal range distribution hint
-static bool validate_golden_candle(Context* c, double high, double low){
-    double size_points = (high - low)/c->point;
-    return size_points >= c->BaseSL_points;
+static uint32_t symbol_hash(const char* s){
+    uint32_t h = 2166136261u;
+    for(; *s; ++s){ h ^= (uint8_t)*s; h *= 16777619u; }
+    return h;
 }
 
-// MA up arrow (fast EMA1 close above slow EMA3(shift1))
-static bool ma_up_signal(Context* c, double close, double prev_slow){
-    // We emulate shift by using previous slow we carry per minute
-    double fast = ema_update(c->ema_fast, close, 1.0); // alpha=1 for EMA1
-    double slow = ema_update(c->ema_slow, close, 0.5); // rough EMA3
-    c->ema_fast = fast; c->ema_slow = slow;
-    return fast > prev_slow;
+// ===== Sharded engine =====
+// Runs on the worker that owns m.handle; the exported entry points keep their
+// stats, trace spans and budgets as if the terminal had called them.
+namespace ea {
+void shard_dispatch(const ShardMsg& m){
+    switch(m.kind){
+    case SM_TICK: {
+        int32_t action = EA_NONE;
+        EA_OnTick(m.handle, m.a, m.b, m.t, m.i0, &action);
+        if(action!=EA_PLAN_ORDERS) return;
+        Context* c = G(m.handle);
+        if(!c) return;
+        EA_ShardPlan p;
+        static_assert(kMaxPlan<=(int32_t)(sizeof(p.legs)/sizeof(p.legs[0])), "EA_ShardPlan holds a full plan");
+        p.handle = m.handle;
+        p.count  = c->cold.plan_n;
+        p.time   = m.t;
+        const double scale = c->spec.scale;
+        for(int32_t i=0;i<p.count;++i){
+            const PlannedOrder& o = c->cold.plan[i];
+            p.legs[i] = EA_ShardLeg{ to_price(o.entry, scale), to_price(o.sl, scale),
+                                     to_price(o.tp, scale), o.lots, o.qual };
+        }
+        shard_emit(p);
+        return;
+    }
+    case SM_ORDER_PLACED: EA_OnOrderPlaced(m.handle, m.i0, m.i1); return;
+    case SM_ORDER_FILLED: EA_OnOrderFilled(m.handle, m.i0, m.a); return;
+    case SM_ORDER_CLOSED: EA_OnOrderClosed(m.handle, m.i0, m.i1 & 1, (m.i1>>1) & 1); return;
+    }
 }
+} // namespace ea
+
+static int32_t shard_route(int32_t handle, const ea::ShardMsg& m){
+    Context* c=G(handle); if(!c) return -1;
+    return ea::shard_submit(c->cold.symbol_hash, m) ? 1 : 0;
+}
+
+// ===== Tick pipeline =====
+// Full-path tail of a tick: keep updating SAR each tick using current
+// highs/lows (plus any extremes seen by conflated ticks since the last update).
+template<class S>
+static inline void sar_tick(Context* c, const Config& cf, int64_t bid, int64_t ask){
+    HotState& h = c->hot;
+    int64_t hi = std::max(bid,ask), lo = std::min(bid,ask);
+    if(cf.conflate){
+        hi = std::max(hi, h.cf_high); lo = std::min(lo, h.cf_low);
+        h.cf_high = kNoHigh; h.cf_low = kNoLow;
+        h.cf_ref2 = bid+ask;
+    }
+    ea::bump(h.ticks_full);
+    if constexpr(S::SarPolicy::kPerTick){
+        EA_STAGE(c, EA_STAGE_SAR);
+        sar_update(c, cf, hi, lo);
+    }
+}
+
+// Closes the signal candle: signals and funnel on it, then the plan when an
+// entry rule holds. reopen starts the next candle with this tick (a new
+// minute, or the tick after a range bar); otherwise the candle is left empty
+// for the next tick to open (a range bar closed by its completing tick).
+// Returns 1 with a plan.
+template<class S>
+static int32_t close_candle(Context* c, const Config& cf, int32_t handle, int64_t mb, bool reopen,
+                            int64_t bid, int64_t ask, int32_t* action_out){
+    HotState& h = c->hot;
+    (void)handle;
+    EA_TRACE(candle_span, ea::TR_CANDLE, handle, c->cold.level.load(std::memory_order_relaxed));
+    // finalize previous candle (last_high/low/close)
+    int64_t prev_close = h.last_close;
+    double  prev_slow  = h.ema_slow;
+
+    // detect signals based on the *previous* candle data
+    bool gc_ok = false, sar_flip_buy=false, ma_buy=false;
+    const bool evaluated = h.last_high!=kNoHigh && h.last_low!=kNoLow && prev_close!=kNoPrice;
+    if(evaluated){
+        EA_TRACE(signal_span, ea::TR_SIGNAL, handle);
+        if constexpr(!S::SarPolicy::kPerTick){
+            EA_STAGE(c, EA_STAGE_SAR);
+            sar_update(c, cf, h.last_high, h.last_low);
+        }
+        {
+            EA_STAGE(c, EA_STAGE_GOLDEN);
+            gc_ok = S::Validator::valid(cf, ea::CandleView{h.last_open, h.last_high, h.last_low, prev_close});
+            // SAR flip handled by sar_dir change (computed through updates in previous minute)
+            sar_flip_buy = (h.sar_dir>0 && h.sar < prev_close); // SAR under price and uptrend just confirmed
+        }
+        EA_STAGE(c, EA_STAGE_MA);
+        if(std::isfinite(prev_slow)) ma_buy = ma_up_signal<typename S::MaPolicy>(h, prev_close, prev_slow);
+        else (void)ma_up_signal<typename S::MaPolicy>(h, prev_close, (double)prev_close); // seed EMAs
+    }
+    if(gc_ok)        ea::bump(c->counters.signals[SIG_GOLDEN]);
+    if(sar_flip_buy) ea::bump(c->counters.signals[SIG_SAR_FLIP]);
+    if(ma_buy)       ea::bump(c->counters.signals[SIG_MA]);
+    // Funnel: an evaluated candle stops at exactly one gate, bucketed by its open
+    const int64_t candle_time = h.last_minute;
+    const bool entry_rule = gc_ok && (sar_flip_buy || ma_buy);
+    if(evaluated){
+        funnel_count(c, candle_time, EA_FUNNEL_CANDLES);
+        if(sar_flip_buy) funnel_count(c, candle_time, EA_FUNNEL_SAR_UP);
+        if(ma_buy)       funnel_count(c, candle_time, EA_FUNNEL_MA_UP);
+        if(!gc_ok)            funnel_count(c, candle_time, EA_FUNNEL_NOT_GOLDEN);
+        else if(!entry_rule)  funnel_count(c, candle_time, EA_FUNNEL_NO_TRIGGER);
+    }
+    // reset for new candle aggregation
+    h.rb_span = 0;
+    if(reopen){
+        h.last_minute = mb;
+        S::Aggregator::open(h, bid, ask);
+    } else {
+        h.last_open = h.last_close = kNoPrice;
+        h.last_high = kNoHigh; h.last_low = kNoLow;
+    }
+
+    // Prepare plan when any entry rule is met (BUY only). The last plan stays
+    // readable until the next evaluated close, past a range bar's opening tick.
+    if(evaluated){
+        c->cold.plan_n = 0;   // its unplaced legs give their reservation back
+        exposure_give_back(c, c->cold.resv_legs - c->cold.pending_n);
+    }
+    const bool htf_ok = entry_rule && htf_confirms(c, cf, prev_close);
+    if(entry_rule && !htf_ok) funnel_count(c, candle_time, EA_FUNNEL_HTF_VETO);
+    if(!htf_ok) return 0;
+    EA_STAGE(c, EA_STAGE_PLAN);
+    EA_TRACE(plan_span, ea::TR_PLAN, handle, 0, &c->cold.plan_n);
+    const int32_t level = c->cold.level.load(std::memory_order_relaxed);
+    // R:R list by level
+    const ea::LevelSchema& sch = S::Levels::legs(level);
+
+    // Account-wide limits and kill switch, shared by all contexts. The last
+    // plan's placed legs stop being tracked here, so their reservation goes.
+    exposure_give_back(c, c->cold.resv_legs);
+    const int32_t legs = std::min(sch.n, kMaxPlan);
+    int64_t resv = 0;
+    bool slot = false;
+    if(ea::account_veto(mb/86400, level, legs*ea::lots_to_micro(cf.lots), c->cold.active_level!=0, &resv, &slot)){
+        funnel_count(c, candle_time, EA_FUNNEL_RISK_VETO);
+        return 0;
+    }
+    if(slot) c->cold.active_level = std::clamp(level, 1, ea::kMaxLevel);
+    if(resv || slot){ c->cold.resv_legs = legs; c->cold.resv_micro = resv; }
+    // reference = close_of_signal + 3500 points (per spec)
+    int64_t entry = prev_close + cf.EntryOffset_points;
+    int64_t sl    = entry - cf.BaseSL_points;
+
+    for(int32_t i=0;i<sch.n && i<kMaxPlan;++i){
+        int64_t tp = entry + (int64_t)cf.BaseSL_points * sch.rr[i];
+        PlannedOrder& po = c->cold.plan[c->cold.plan_n++];
+        po.entry=entry; po.sl=sl; po.tp=tp; po.lots=cf.lots;
+        po.qual = sch.qual[i];
+    }
+    c->cold.plan_us = ea::exec_now_us();
+    c->cold.plan_level = level;
+    c->cold.plan_placed = 0;
+    c->cold.pending_n = 0;
+    *action_out = EA_PLAN_ORDERS;
+    ea::bump(c->counters.plans);
+    funnel_count(c, candle_time, EA_FUNNEL_PLANNED);
+    return 1;
+}
+
+// One instantiation per strategy bundle (strategy.h); EA_OnTick and
+// EA_OnTicks run Strat. The caller has resolved the handle.
+template<class S>
+static int32_t tick(Context* c, int32_t handle, double bid_px, double ask_px, int64_t t, int32_t hasOpenPosition, int32_t* action_out){
+    EA_TRACE(tick_span, ea::TR_TICK, handle, 0, action_out);
+    HotState& h = c->hot;
+    const Config& cf = config(c);
+    *action_out = EA_NONE;
+
+    EA_STAGE_BEGIN(c, EA_STAGE_BUCKET, bucket_stage);
+    const int64_t bid = to_points(bid_px, c->spec.scale);
+    const int64_t ask = to_points(ask_px, c->spec.scale);
+
+    // Build candle buckets for M1; the multi-timeframe bars follow the market
+    // even while paused or in a trade
+    int64_t mb = minute_bucket(t);
+    bars_tick(c, cf, bid, ask, mb);
+    if(cf.paused || hasOpenPosition){
+        funnel_count(c, t, cf.paused ? EA_FUNNEL_PAUSED : EA_FUNNEL_IN_POSITION);
+        return 0;
+    }
+
+    // Signal candle boundary: a new minute, or in range-bar mode the first tick
+    // after the previous bar closed (on its completing tick, below)
+    const bool range_mode = cf.range_points>0;
+    if(range_mode ? h.last_close==kNoPrice : mb != h.last_minute){
+        EA_STAGE_END(bucket_stage);
+        if(close_candle<S>(c, cf, handle, mb, true, bid, ask, action_out)){
+            ea::bump(h.ticks_full);
+            return 1;
+        }
+    } else {
+        // aggregate current candle OHLC approximation (exact even when conflated)
+        const int64_t low0 = h.last_low;
+        const bool extends = S::Aggregator::fold(h, bid, ask);
+        // Range bars span the bid only, so the spread never completes one
+        bool completes = false;
+        if(range_mode){
+            const int64_t span = low0==kNoLow ? 0 : std::max<int64_t>(h.rb_span + (low0 - h.last_low), bid - h.last_low);
+            h.rb_span = (int32_t)std::min<int64_t>(span, INT32_MAX);
+            completes = span >= cf.range_points;
+        }
+
+        if(cf.conflate && !completes){
+            h.cf_high = std::max(h.cf_high, std::max(bid,ask));
+            h.cf_low  = std::min(h.cf_low,  std::min(bid,ask));
+            bool small = false;
+            if(cf.conflate_thr2>0 && h.cf_ref2!=kNoPrice){
+                const int64_t d2 = (bid+ask) - h.cf_ref2;
+                small = (d2<0?-d2:d2) < cf.conflate_thr2;
+            }
+            if(!extends || small){ ea::bump(h.ticks_conflated); return 0; }
+        }
+        EA_STAGE_END(bucket_stage);
+        if(completes){
+            // The completing tick steps the SAR like any tick of the bar, then
+            // closes it; the next tick opens the next bar
+            sar_tick<S>(c, cf, bid, ask);
+            return close_candle<S>(c, cf, handle, mb, false, bid, ask, action_out);
+        }
+    }
+    sar_tick<S>(c, cf, bid, ask);
+    return 0;
+}
+
+using Strat = EA_CORE_STRATEGY;
 
 extern "C" {
 
 EA_API int32_t EA_CALL EA_CreateContext() {
     std::lock_guard<std::mutex> lk(g_mtx);
-    int32_t h = g_next++;
-    g_ctx[h]= new Context();
+    if(g_free.empty()){
+        if(g_nblocks>=kMaxBlocks) return -1;
+        if(g_nblocks==0) g_free.reserve(kMaxBlocks*kBlockSlots);
+        else g_blocks[g_nblocks].store(new Block(), std::memory_order_release);
+        for(int32_t i=kBlockSlots-1;i>=0;--i) g_free.push_back(g_nblocks*kBlockSlots + i);
+        ++g_nblocks;
+    }
+    int32_t idx = g_free.back();
+    if(!g_hist[idx]) g_hist[idx] = new (std::nothrow) History;
+    if(!g_exec[idx]) g_exec[idx] = new (std::nothrow) ea::ExecTable;
+    if(!g_hist[idx] || !g_exec[idx]) return -1;     // slot stays free; a later call retries
+    g_free.pop_back();
+    Slot* s = slot_at(idx);
+    s->ctx.~Context();
+    new (&s->ctx) Context();
+    s->ctx.hist = g_hist[idx];
+    s->ctx.hist->head = s->ctx.hist->count = 0;
+    s->ctx.exec = g_exec[idx];
+    s->ctx.exec->n = 0;
+    g_gen = (g_gen+1) & kGenMask; if(g_gen==0) g_gen=1;
+    int32_t h = (g_gen<<kSlotBits) | (idx+1);
+    s->ctx.cold.handle = h;
+    s->handle.store(h, std::memory_order_release);
     return h;
 }
 EA_API void EA_CALL EA_DestroyContext(int32_t handle){
     std::lock_guard<std::mutex> lk(g_mtx);
-    auto it=g_ctx.find(handle);
-    if(it!=g_ctx.end()){ delete it->second; g_ctx.erase(it); }
+    Context* c=G(handle); if(!c) return;
+    leave_degraded(c, ea::cycles());
+    exposure_release_all(c);
+    int32_t idx = (handle & kSlotMask) - 1;
+    slot_at(idx)->handle.store(0, std::memory_order_release);
+    g_free.push_back(idx);
 }
 
 EA_API int32_t EA_CALL EA_Init(int32_t handle, const char* symbol, int32_t magic, int32_t digits, double point){
     Context* c=G(handle); if(!c) return -1;
-    c->symbol = symbol?symbol:c->symbol;
-    c->magic = magic; c->digits=digits; c->point=point;
-    c->sar = NAN; c->ema_fast=NAN; c->ema_slow=NAN;
-    c->targets_hit=0; c->plan.clear();
-    c->last_error.clear();
+    EA_TIMED(c, EA_FN_INIT);
+    if(symbol) set_text(c->cold.symbol, sizeof(c->cold.symbol), symbol);
+    c->cold.symbol_hash = symbol_hash(c->cold.symbol);
+    c->cold.magic = magic; c->spec.digits=digits; c->spec.point=point;
+    c->spec.scale = points_scale(digits, point);
+    watch_configure(c, config(c));
+    reset_indicators(c);
+    c->cold.targets_hit=0;
+    c->hot.ticks_full.store(0, std::memory_order_relaxed);
+    c->hot.ticks_conflated.store(0, std::memory_order_relaxed);
     return 1;
 }
 
 EA_API void EA_CALL EA_Reset(int32_t handle){
     Context* c=G(handle); if(!c) return;
-    c->sar = NAN; c->ema_fast=NAN; c->ema_slow=NAN;
-    c->plan.clear();
-    c->last_error.clear();
+    EA_TIMED(c, EA_FN_RESET);
+    reset_indicators(c);
 }
 
-EA_API int32_t EA_CALL EA_OnTick(int32_t handle, double bid, double ask, int64_t t, int32_t hasOpenPosition, int32_t* action_out){
-    Context* c=G(handle); if(!c||!action_out) return -1;
-    *action_out = EA_NONE;
-    if(c->paused || hasOpenPosition) return 0;
+EA_API int32_t EA_CALL EA_Warmup(int32_t handle, const int64_t* time,
+                                const double* op, const double* hi, const double* lo, const double* cl,
+                                int32_t n){
+    Context* c=G(handle); if(!c) return -1;
+    if(!time||!hi||!lo||!cl||n<0) return arg_error(c, "EA_Warmup: null series or negative count");
+    EA_TIMED(c, EA_FN_WARMUP);
+    reset_indicators(c);
 
-    // spread check if configured
-    if(c->min_spread_points>0 && ((ask-bid)/c->point) < 0) { /*no min*/ }
+    // Only the newest week is replayed (what the M1 history holds, plus the
+    // forming bar): the EMAs forget older closes within a few dozen bars, and
+    // the SAR starts at the week's first bar as the higher timeframes do.
+    // Older bars were most of a long warmup's cost (budget: under 1 ms).
+    const Config& cf = config(c);
+    const double scale = c->spec.scale;
+    auto usable = [&](int32_t i){ return std::isfinite(hi[i]) && std::isfinite(lo[i]) && std::isfinite(cl[i]); };
+    int32_t last = -1, first = -1, kept = 0;
+    for(int32_t i=n-1;i>=0 && kept<=kHistBars;--i)
+        if(usable(i)){ if(last<0) last = i; first = i; ++kept; }
 
-    // Build candle buckets for M1
-    int64_t mb = minute_bucket(t);
-    bool new_candle = (mb != c->last_minute);
-    if(new_candle){
-        // finalize previous candle (last_high/low/close)
-        double prev_close = c->last_close;
-        double prev_slow  = c->ema_slow;
-
-        // detect signals based on the *previous* candle data
-        bool gc_ok = false, sar_flip_buy=false, ma_buy=false;
-        if(std::isfinite(c->last_high) && std::isfinite(c->last_low) && std::isfinite(prev_close)){
-            gc_ok = validate_golden_candle(c, c->last_high, c->last_low);
-            // SAR flip handled by sar_dir change (computed through updates in previous minute)
-            sar_flip_buy = (c->sar_dir>0 && c->sar < prev_close); // SAR under price and uptrend just confirmed
-            if(std::isfinite(prev_slow)) ma_buy = ma_up_signal(c, prev_close, prev_slow);
-            else (void)ma_up_signal(c, prev_close, prev_close); // seed EMAs
-        }
-        // reset for new candle aggregation
-        c->last_minute = mb;
-        c->last_high = -INFINITY; c->last_low=INFINITY;
-        c->last_close = ask; // seed
-
-        // Prepare plan when any entry rule is met (BUY only)
-        c->plan.clear();
-        if(gc_ok && (sar_flip_buy || ma_buy)){
-            // reference = close_of_signal + 3500 points (per spec)
-            double entry = norm_price(prev_close + c->EntryOffset_points * c->point, c->digits);
-            double sl    = norm_price(entry - c->BaseSL_points * c->point, c->digits);
-
-            // R:R list by level
-            std::vector<double> rrs; std::vector<int32_t> quals;
-            level_rr_schema(c->level, rrs, quals);
-
-            for(size_t i=0;i<rrs.size();++i){
-                double tp = norm_price(entry + (c->BaseSL_points * c->point) * rrs[i], c->digits);
-                PlannedOrder po;
-                po.entry=entry; po.sl=sl; po.tp=tp; po.lots=0.01; // fixed lots per spec
-                po.qual = quals[i];
-                c->plan.push_back(po);
-            }
-            *action_out = EA_PLAN_ORDERS;
-            return 1;
+    // Candle-level recurrences on locals (in points). The live path folds a candle's
+    // close into the EMAs when the next candle opens, so the last close is left pending.
+    double sar=NAN, ep=NAN, af=cf.SAR_step; int32_t dir=0;
+    double ema_fast=NAN, ema_slow=NAN;
+    const double step=cf.SAR_step, af_max=cf.SAR_max;
+    int32_t used = 0;
+    double pending_close = NAN;
+    for(int32_t i=first;i>=0 && i<=last;++i){
+        if(!usable(i)) continue;
+        if(used>0){
+            Strat::MaPolicy::update(ema_fast, ema_slow, pending_close);
         }
-    } else {
-        // aggregate current candle OHLC approximation
-        c->last_high = std::max(c->last_high, ask);
-        c->last_low  = std::min(c->last_low,  bid);
-        c->last_close= ask;
+        ea::sar_step(sar, ep, af, dir, step, af_max, round_points(hi[i], scale), round_points(lo[i], scale));
+        pending_close = round_points(cl[i], scale);
+        ++used;
+        // History bars carry no tick volume; without opens the close stands in
+        bars_roll(c, cf, minute_bucket(time[i]));
+        Bar& b = c->bars.tf[EA_TF_M1].forming;
+        b.close = to_points(cl[i], scale);
+        b.open  = (op && std::isfinite(op[i])) ? to_points(op[i], scale) : b.close;
+        b.high  = to_points(hi[i], scale);
+        b.low   = to_points(lo[i], scale);
+    }
+    HotState& h = c->hot;
+    h.sar=sar; h.sar_ep=ep; h.sar_af=af; h.sar_dir=dir;
+    h.ema_fast=ema_fast; h.ema_slow=ema_slow;
+    if(last>=0){
+        h.last_minute = minute_bucket(time[last]);
+        h.last_high   = to_points(hi[last], scale);
+        h.last_low    = to_points(lo[last], scale);
+        h.last_close  = (int64_t)pending_close;
+        h.last_open   = c->bars.tf[EA_TF_M1].forming.open;
     }
+    return used;
+}
 
-    // Keep updating SAR each tick using current highs/lows
-    sar_update(c, std::max(bid,ask), std::min(bid,ask));
-    return 0;
+EA_API int32_t EA_CALL EA_OnTick(int32_t handle, double bid_px, double ask_px, int64_t t, int32_t hasOpenPosition, int32_t* action_out){
+    EA_STAGE_MARK(t_tick);
+    Context* c=G(handle); if(!c) return -1;
+    if(!action_out) return arg_error(c, "EA_OnTick: null action_out");
+    EA_STAGE_RECORD(c, EA_STAGE_LOOKUP, t_tick);
+    EA_STAGE_SINCE(c, EA_STAGE_TICK, t_tick);
+    EA_TIMED(c, EA_FN_ONTICK);
+    return tick<Strat>(c, handle, bid_px, ask_px, t, hasOpenPosition, action_out);
+}
+
+EA_API int32_t EA_CALL EA_OnTicks(int32_t handle, const int64_t* time, const double* bid, const double* ask,
+                                  int32_t n, int32_t hasOpenPosition, int32_t* action_out){
+    Context* c=G(handle); if(!c) return -1;
+    if(!time||!bid||!ask||!action_out||n<0) return arg_error(c, "EA_OnTicks: null series or negative count", -2);
+    *action_out = EA_NONE;
+    for(int32_t i=0;i<n;++i){
+        EA_STAGE_MARK(t_tick);
+        EA_STAGE_SINCE(c, EA_STAGE_TICK, t_tick);
+        if(tick<Strat>(c, handle, bid[i], ask[i], time[i], hasOpenPosition, action_out)==1) return i+1;
+    }
+    return n;
 }
 
 EA_API int32_t EA_CALL EA_PlanOrdersCount(int32_t handle){
     Context* c=G(handle); if(!c) return -1;
-    return (int32_t)c->plan.size();
+    EA_TIMED(c, EA_FN_PLAN_COUNT);
+    return c->cold.plan_n;
 }
 EA_API int32_t EA_CALL EA_PlanOrderGet(int32_t handle, int32_t index,
                                        double* entry, double* sl, double* tp, double* lots, int32_t* qual){
     Context* c=G(handle); if(!c) return -1;
-    if(index<0 || index>=(int32_t)c->plan.size()) return -2;
-    const auto& p = c->plan[(size_t)index];
-    if(entry) *entry = p.entry;
-    if(sl)    *sl    = p.sl;
-    if(tp)    *tp    = p.tp;
+    EA_TIMED(c, EA_FN_PLAN_GET);
+    if(index<0 || index>=c->cold.plan_n) return arg_error(c, "EA_PlanOrderGet: index out of range", -2);
+    const auto& p = c->cold.plan[index];
+    const double scale = c->spec.scale;
+    if(entry) *entry = to_price(p.entry, scale);
+    if(sl)    *sl    = to_price(p.sl,    scale);
+    if(tp)    *tp    = to_price(p.tp,    scale);
     if(lots)  *lots  = p.lots;
     if(qual)  *qual  = p.qual;
     return 1;
 }
 
-EA_API void EA_CALL EA_OnOrderPlaced(int32_t, int32_t, int32_t){ /* no-op for now */ }
-EA_API void EA_CALL EA_OnOrderFilled(int32_t, int32_t, double){  /* no-op for now */ }
+EA_API void EA_CALL EA_OnOrderPlaced(int32_t handle, int32_t ticket, int32_t qual){
+    Context* c=G(handle); if(!c) return;
+    EA_TIMED(c, EA_FN_ORDER_PLACED);
+    EA_TRACE(span, ea::TR_ORDER_PLACED, handle, ticket);
+    exec_placed(c, ticket, qual);
+}
+EA_API void EA_CALL EA_OnOrderFilled(int32_t handle, int32_t ticket, double fill_price){
+    Context* c=G(handle); if(!c) return;
+    EA_TIMED(c, EA_FN_ORDER_FILLED);
+    EA_TRACE(span, ea::TR_ORDER_FILLED, handle, ticket);
+    exposure_fill(c, ticket);
+    exec_filled(c, ticket, fill_price);
+}
 
-EA_API void EA_CALL EA_OnOrderClosed(int32_t handle, int32_t /*ticket*/, int32_t closed_by_tp, int32_t closed_by_sl){
+EA_API void EA_CALL EA_OnOrderClosed(int32_t handle, int32_t ticket, int32_t closed_by_tp, int32_t closed_by_sl){
     Context* c=G(handle); if(!c) return;
+    EA_TIMED(c, EA_FN_ORDER_CLOSED);
+    EA_TRACE(span, ea::TR_ORDER_CLOSED, handle, ticket);
+    exposure_close(c, ticket);
+    exec_forget(c, ticket);   // a pending order cancelled or expired
     // Simple level progression: if TP → next level, if SL → restart level 1
+    std::atomic<int32_t>& level = c->cold.level;
     if(closed_by_tp){
-        c->level = std::min(25, c->level+1);
+        level.store(std::min(25, level.load(std::memory_order_relaxed)+1), std::memory_order_relaxed);
     } else if(closed_by_sl){
-        c->level = 1;
+        level.store(1, std::memory_order_relaxed);
     }
-    c->targets_hit = 0;
+    c->cold.targets_hit = 0;
 }
 
 EA_API int32_t EA_CALL EA_CurrentLevel(int32_t handle){
     Context* c=G(handle); if(!c) return -1;
-    return c->level;
+    EA_TIMED(c, EA_FN_CURRENT_LEVEL);
+    return c->cold.level.load(std::memory_order_relaxed);
 }
 EA_API void EA_CALL EA_ApplyLevel(int32_t handle, int32_t level){
     Context* c=G(handle); if(!c) return;
-    c->level = std::clamp(level,1,25);
+    EA_TIMED(c, EA_FN_APPLY_LEVEL);
+    c->cold.level.store(std::clamp(level,1,25), std::memory_order_relaxed);
 }
 
 // SL advisory: move to BE at 3rd target, to 1st level at 6th target.
 // We approximate targets by (entry + n*BaseSL_points) distance checkpoints.
 EA_API int32_t EA_CALL EA_AdviseSL(int32_t handle, double current_price, double* new_sl_out, int32_t* should_modify_out){
-    Context* c=G(handle); if(!c||!new_sl_out||!should_modify_out) return -1;
+    Context* c=G(handle); if(!c) return -1;
+    if(!new_sl_out||!should_modify_out) return arg_error(c, "EA_AdviseSL: null output");
+    EA_TIMED(c, EA_FN_ADVISE_SL);
     *should_modify_out = 0;
 
     // We can't know entry here without tracking each trade; keep simple: no-op advisory.
@@ -295,21 +1354,301 @@ EA_API int32_t EA_CALL EA_AdviseSL(int32_t handle, double current_price, double*
     return 0;
 }
 
+// Any thread: only a snapshot is published, so the setters are not timed
+// (the histograms and watchdog belong to the context's calling thread).
 EA_API void EA_CALL EA_SetFlag(int32_t handle, const char* key, int32_t value){
     Context* c=G(handle); if(!c||!key) return;
-    std::string k(key);
-    if(k=="paused") c->paused = (value!=0);
+    config_update(c, [&](Config& cf){ return config_set(cf, key, value)==1; });
 }
 EA_API void EA_CALL EA_SetParamDouble(int32_t handle, const char* key, double value){
     Context* c=G(handle); if(!c||!key) return;
-    std::string k(key);
-    if(k=="min_spread_points") c->min_spread_points = value;
+    config_update(c, [&](Config& cf){ return config_set(cf, key, value)==1; });
+}
+
+EA_API int32_t EA_CALL EA_TickCounters(int32_t handle, int64_t* full_ticks, int64_t* conflated_ticks){
+    Context* c=G(handle); if(!c) return -1;
+    EA_TIMED(c, EA_FN_TICK_COUNTERS);
+    if(full_ticks)      *full_ticks      = c->hot.ticks_full.load(std::memory_order_relaxed);
+    if(conflated_ticks) *conflated_ticks = c->hot.ticks_conflated.load(std::memory_order_relaxed);
+    return 1;
 }
 
 EA_API const char* EA_CALL EA_LastError(int32_t handle){
     Context* c=G(handle); if(!c) return "invalid_handle";
-    return c->last_error.c_str();
+    EA_TIMED(c, EA_FN_LAST_ERROR);
+    return c->cold.last_error;
 }
 EA_API const char* EA_CALL EA_Version(){ return "GoldenCandle-Core 1.0.0"; }
 
+EA_API int32_t EA_CALL EA_GetStats(int32_t handle, EA_Stats* out){
+    Context* c=G(handle); if(!c||!out) return -1;
+    std::memset(out, 0, sizeof(*out));
+    out->enabled  = EA_CORE_STATS;
+    out->fn_count = EA_FN_COUNT;
+    const double cpn = ea::cycles_per_ns();
+    out->cycles_per_ns = cpn;
+    for(int32_t i=0;i<EA_FN_COUNT;++i){
+        const ea::LatencyHistogram& hs = c->stats[i];
+        EA_CallStats& o = out->fn[i];
+        o.calls = (int64_t)hs.calls.load(std::memory_order_relaxed);
+        if(o.calls==0) continue;
+        o.mean_ns = (double)hs.total.load(std::memory_order_relaxed)/(double)o.calls/cpn;
+        const uint64_t mx = hs.max.load(std::memory_order_relaxed);
+        o.max_ns  = (double)mx/cpn;
+        // bucket upper bounds, capped by the exact max
+        o.p50_ns  = (double)std::min(hs.quantile(0.50),  mx)/cpn;
+        o.p90_ns  = (double)std::min(hs.quantile(0.90),  mx)/cpn;
+        o.p99_ns  = (double)std::min(hs.quantile(0.99),  mx)/cpn;
+        o.p999_ns = (double)std::min(hs.quantile(0.999), mx)/cpn;
+    }
+    return 1;
+}
+EA_API void EA_CALL EA_ResetStats(int32_t handle){
+    Context* c=G(handle); if(!c) return;
+    c->watch.stats_reset.store(1, std::memory_order_relaxed);   // applied by stats_reset_poll
+}
+
+EA_API int32_t EA_CALL EA_GetStageStats(int32_t handle, EA_StageStats* out){
+    Context* c=G(handle); if(!c||!out) return -1;
+    std::memset(out, 0, sizeof(*out));
+    out->enabled     = EA_CORE_PROFILE;
+    out->stage_count = EA_STAGE_COUNT;
+#if EA_CORE_PROFILE
+    out->cycles_per_ns = ea::cycles_per_ns();
+    for(int32_t i=0;i<EA_STAGE_COUNT;++i){
+        const ea::LatencyHistogram& hs = c->stages[i];
+        EA_StageRow& o = out->stage[i];
+        o.calls = (int64_t)hs.calls.load(std::memory_order_relaxed);
+        if(o.calls==0) continue;
+        const uint64_t mx = hs.max.load(std::memory_order_relaxed);
+        o.total_cycles = (int64_t)hs.total.load(std::memory_order_relaxed);
+        o.mean_cycles  = (double)o.total_cycles/(double)o.calls;
+        o.max_cycles   = (double)mx;
+        o.p50_cycles   = (double)std::min(hs.quantile(0.50), mx);
+        o.p90_cycles   = (double)std::min(hs.quantile(0.90), mx);
+        o.p99_cycles   = (double)std::min(hs.quantile(0.99), mx);
+    }
+#endif
+    return 1;
+}
+
+
+EA_API int32_t EA_CALL EA_TraceEnable(int32_t on){
+#if EA_CORE_TRACE
+    const uint32_t prev = on ? ea::g_trace_state.fetch_or(1u, std::memory_order_relaxed)
+                             : ea::g_trace_state.fetch_and(~1u, std::memory_order_relaxed);
+    return (prev & 1u) ? 1 : 0;
+#else
+    (void)on; return -1;
+#endif
+}
+
+EA_API int32_t EA_CALL EA_TraceDump(const char* path, double last_seconds){
+    return ea::trace_dump(path, last_seconds);
+}
+
+EA_API int32_t EA_CALL EA_MetricsStart(int32_t port){ return ea::metrics_start(port); }
+EA_API void    EA_CALL EA_MetricsStop(){ ea::metrics_stop(); }
+
+EA_API int32_t EA_CALL EA_MetricsRender(char* buf, int32_t cap){
+    std::string out;
+    ea::render_metrics(out);
+    if(buf && cap>0){
+        size_t n = std::min(out.size(), (size_t)cap-1);
+        std::memcpy(buf, out.data(), n);
+        buf[n] = '\0';
+    }
+    return (int32_t)out.size();
+}
+
+EA_API int32_t EA_CALL EA_GetBudgetStatus(int32_t handle, EA_BudgetStatus* out){
+    Context* c=G(handle); if(!c||!out) return -1;
+    std::memset(out, 0, sizeof(*out));
+    const Watchdog& w = c->watch;
+    out->last_fn = -1;
+#if EA_CORE_STATS
+    const double ms_per_cycle = 1e-6/ea::cycles_per_ns();
+    const uint64_t since = w.degraded_since.load(std::memory_order_relaxed);
+    uint64_t deg = w.degraded_cycles.load(std::memory_order_relaxed);
+    if(since) deg += ea::cycles() - since;
+    out->degraded         = since ? 1 : 0;
+    out->last_fn          = w.last_fn.load(std::memory_order_relaxed);
+    out->last_overrun_ms  = (double)w.last_cycles.load(std::memory_order_relaxed)*ms_per_cycle;
+    out->degraded_entries = w.degraded_entries.load(std::memory_order_relaxed);
+    out->degraded_ms      = (double)deg*ms_per_cycle;
+    for(int32_t f=0;f<EA_FN_COUNT;++f){
+        out->overruns_by_fn[f] = w.overruns[f].load(std::memory_order_relaxed);
+        out->overruns += out->overruns_by_fn[f];
+    }
+    return 1;
+#else
+    (void)w; return 0;
+#endif
+}
+
+EA_API void EA_CALL EA_SetAccountLimit(const char* key, double value){ ea::account_set_limit(key, value); }
+
+EA_API int32_t EA_CALL EA_KillSwitch(int32_t on){
+    return ea::g_account.kill.exchange(on!=0 ? 1 : 0, std::memory_order_acq_rel);
+}
+
+EA_API void EA_CALL EA_ReportClosedProfit(int32_t handle, double profit){
+    Context* c=G(handle); if(!c||!std::isfinite(profit)) return;
+    const int64_t day = c->hot.last_minute>=0 ? c->hot.last_minute/86400 : 0;
+    ea::account_add_pnl(day, (int64_t)std::llround(profit*100));
+}
+
+EA_API int32_t EA_CALL EA_GetAccountRisk(EA_AccountRisk* out){
+    if(!out) return -1;
+    ea::account_snapshot(out);
+    return 1;
+}
+
+EA_API int32_t EA_CALL EA_GetBars(int32_t handle, int32_t tf, int32_t shift, int32_t count, EA_Bar* out){
+    Context* c=G(handle); if(!c) return -1;
+    if(tf<0 || tf>=EA_TF_COUNT || shift<0 || count<0 || (count>0 && !out))
+        return arg_error(c, "EA_GetBars: bad timeframe, shift or count", -2);
+    const double scale = c->spec.scale;
+    int32_t n = 0;
+    Bar b;
+    while(n<count && bars_get(c, tf, shift+n, b)){
+        EA_Bar& o = out[n++];
+        o.time  = b.time;
+        o.open  = to_price(b.open,  scale);
+        o.high  = to_price(b.high,  scale);
+        o.low   = to_price(b.low,   scale);
+        o.close = to_price(b.close, scale);
+        o.ticks = b.ticks;
+    }
+    return n;
+}
+
+EA_API int32_t EA_CALL EA_GetTfSar(int32_t handle, int32_t tf, double* sar, int32_t* dir){
+    Context* c=G(handle); if(!c) return -1;
+    if(tf<0 || tf>=EA_TF_COUNT) return arg_error(c, "EA_GetTfSar: bad timeframe", -2);
+    const TfSeries& s = c->bars.tf[tf];
+    const double  v = tf==EA_TF_M1 ? c->hot.sar     : s.sar;
+    const int32_t d = tf==EA_TF_M1 ? c->hot.sar_dir : s.sar_dir;
+    if(sar) *sar = std::isnan(v) ? 0.0 : v/c->spec.scale;
+    if(dir) *dir = d;
+    return std::isnan(v) ? 0 : 1;
+}
+
+EA_API int32_t EA_CALL EA_HistoryCount(int32_t handle){
+    Context* c=G(handle); if(!c) return -1;
+    return c->hist->count;
+}
+
+EA_API int32_t EA_CALL EA_HistoryCopy(int32_t handle, int32_t shift, int32_t count,
+                                      int64_t* time, double* open, double* high, double* low, double* close,
+                                      int64_t* ticks, int32_t* spread_min, int32_t* spread_max){
+    Context* c=G(handle); if(!c) return -1;
+    if(shift<0 || count<0) return arg_error(c, "EA_HistoryCopy: negative shift or count", -2);
+    const History& hs = *c->hist;
+    const int32_t n = std::max(0, std::min(count, hs.count-shift));
+    if(n==0) return 0;
+    // Oldest requested bar first; the window wraps the ring at most once
+    const int32_t first = hs.at(shift+n-1);
+    const int32_t seg   = std::min(n, kHistBars-first);
+    const double  scale = c->spec.scale;
+    auto column = [&](const auto* src, auto* dst, auto conv){
+        if(!dst) return;
+        for(int32_t i=0;i<seg;++i) dst[i] = conv(src[first+i]);
+        for(int32_t i=seg;i<n;++i) dst[i] = conv(src[i-seg]);
+    };
+    auto same  = [](auto v){ return v; };
+    auto price = [scale](int64_t v){ return to_price(v, scale); };
+    column(hs.time,  time,  same);
+    column(hs.open,  open,  price);
+    column(hs.high,  high,  price);
+    column(hs.low,   low,   price);
+    column(hs.close, close, price);
+    column(hs.ticks, ticks, [](int32_t v){ return (int64_t)v; });
+    column(hs.spread_min, spread_min, same);
+    column(hs.spread_max, spread_max, same);
+    return n;
+}
+
+EA_API int32_t EA_CALL EA_ConfigLoad(int32_t handle, const char* path){
+    Context* c=G(handle); if(!c) return -1;
+    if(!path || !*path) return arg_error(c, "EA_ConfigLoad: empty path", -2);
+    struct stat st;
+    if(::stat(path, &st)!=0) return arg_error(c, "EA_ConfigLoad: cannot stat file", -2);
+    return config_load(c, path, (int64_t)st.st_mtime, (int64_t)st.st_size);
+}
+
+EA_API int32_t EA_CALL EA_ConfigPoll(int32_t handle){
+    Context* c=G(handle); if(!c) return -1;
+    ColdState& cs = c->cold;
+    if(!cs.config_path[0]) return 0;
+    struct stat st;
+    if(::stat(cs.config_path, &st)!=0) return 0;   // being replaced; try again next poll
+    if((int64_t)st.st_mtime==cs.config_mtime && (int64_t)st.st_size==cs.config_size) return 0;
+    return config_load(c, cs.config_path, (int64_t)st.st_mtime, (int64_t)st.st_size);
+}
+
+EA_API int32_t EA_CALL EA_ShardStart(int32_t workers, int32_t pin){ return ea::shard_start(workers, pin!=0); }
+EA_API void    EA_CALL EA_ShardStop(){ ea::shard_stop(); }
+
+EA_API int32_t EA_CALL EA_ShardSubmitTick(int32_t handle, double bid, double ask, int64_t t, int32_t hasOpenPosition){
+    return shard_route(handle, ea::ShardMsg{ ea::SM_TICK, handle, bid, ask, t, hasOpenPosition, 0 });
+}
+
+EA_API int32_t EA_CALL EA_ShardSubmitOrder(int32_t handle, int32_t event, int32_t a, int32_t b, double price){
+    if(event<EA_SHARD_ORDER_PLACED || event>EA_SHARD_ORDER_CLOSED){
+        Context* c=G(handle); if(!c) return -1;
+        return arg_error(c, "EA_ShardSubmitOrder: unknown event", -2);
+    }
+    static_assert(ea::SM_ORDER_PLACED==(int32_t)EA_SHARD_ORDER_PLACED && ea::SM_ORDER_CLOSED==(int32_t)EA_SHARD_ORDER_CLOSED,
+                  "shard message kinds follow EA_ShardEvent");
+    return shard_route(handle, ea::ShardMsg{ event, handle, price, 0.0, 0, a, b });
+}
+
+EA_API int32_t EA_CALL EA_ShardPollPlan(EA_ShardPlan* out){
+    return out && ea::shard_poll(*out) ? 1 : 0;
+}
+
+EA_API int32_t EA_CALL EA_ShardOf(int32_t handle){
+    Context* c=G(handle); if(!c) return -1;
+    const int32_t n = ea::shard_count();
+    return n ? (int32_t)(c->cold.symbol_hash % (uint32_t)n) : -1;
+}
+
+EA_API int32_t EA_CALL EA_BatchCreate(int32_t lanes, int32_t digits, double point, int32_t isa){
+    return ea::batch_create(lanes, points_scale(digits, point), isa);
+}
+EA_API void    EA_CALL EA_BatchDestroy(int32_t batch){ ea::batch_destroy(batch); }
+EA_API int32_t EA_CALL EA_BatchIsa(int32_t batch){ return ea::batch_isa(batch); }
+EA_API int32_t EA_CALL EA_BatchSetParam(int32_t batch, int32_t lane, const char* key, double value){
+    return ea::batch_set_param(batch, lane, key, value);
+}
+EA_API int32_t EA_CALL EA_BatchOnTick(int32_t batch, double bid, double ask, int64_t t){
+    return ea::batch_on_tick(batch, bid, ask, t);
+}
+EA_API int32_t EA_CALL EA_BatchRun(int32_t batch, const int64_t* time, const double* bid, const double* ask, int32_t n){
+    return ea::batch_run(batch, time, bid, ask, n);
+}
+EA_API int32_t EA_CALL EA_BatchGetLane(int32_t batch, int32_t lane, EA_BatchLane* out){
+    return ea::batch_get_lane(batch, lane, out);
+}
+
+EA_API int32_t EA_CALL EA_GetFunnel(int32_t handle, EA_Funnel* out){
+    Context* c=G(handle); if(!c) return -1;
+    if(!out) return arg_error(c, "EA_GetFunnel: null output", -2);
+    std::memset(out, 0, sizeof(*out));
+    for(int32_t hr=0;hr<24;++hr)
+        for(int32_t g=0;g<EA_FUNNEL_COUNT;++g){
+            const int64_t v = c->funnel.by_hour[hr][g].load(std::memory_order_relaxed);
+            out->by_hour[hr][g] = v;
+            out->total[g] += v;
+        }
+    return 1;
+}
+
+EA_API int32_t EA_CALL EA_GetExecStats(int32_t handle, EA_ExecStats* out, int32_t cap){
+    Context* c=G(handle); if(!c) return -1;
+    if(!out && cap>0) return arg_error(c, "EA_GetExecStats: null output", -2);
+    return ea::exec_snapshot(*c->exec, out, cap);
+}
+
 } // extern "C"
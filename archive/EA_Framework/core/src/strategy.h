@@ -0,0 +1,193 @@
+#pragma once
+// Strategy policies for the per-context tick pipeline (tick in state.cpp).
+// A Strategy bundles one policy of each kind: candle aggregator, SAR, moving
+// averages, golden-candle validator and level schema. Everything is static and
+// picked at compile time, so a variant is inlined like the default and costs
+// no virtual call; the default reproduces the original free functions exactly.
+// The DLL runs EA_CORE_STRATEGY (default ea::DefaultStrategy); research builds
+// pass another bundle, e.g. -DEA_CORE_STRATEGY=ea::BodyWickStrategy.
+//
+// Prices are int64 points. Policies that keep state get the context's
+// HotState as H (fields last_open/high/low/close, ema_fast/ema_slow).
+#include <stdint.h>
+#include <climits>
+#include <cmath>
+#include <algorithm>
+#include "ea_api.h"
+
+static constexpr int64_t kNoPrice = INT64_MIN;  // unset close
+static constexpr int64_t kNoHigh  = INT64_MIN;  // empty candle extremes
+static constexpr int64_t kNoLow   = INT64_MAX;
+
+namespace ea {
+
+// ---- Candle aggregators: the M1 candle the signals are evaluated on ----
+
+// Ask high, bid low, ask close. The first tick of a candle only seeds the
+// close (and open): its extremes are not counted.
+struct AskBidCandle {
+    template<class H> static void open(H& h, int64_t, int64_t ask){
+        h.last_high = kNoHigh; h.last_low = kNoLow;
+        h.last_close = ask; h.last_open = ask;
+    }
+    // True when the tick extends the candle (conflation skips those only for a small move).
+    template<class H> static bool fold(H& h, int64_t bid, int64_t ask){
+        const bool extends = (ask > h.last_high) || (bid < h.last_low);
+        h.last_high = std::max(h.last_high, ask);
+        h.last_low  = std::min(h.last_low,  bid);
+        h.last_close= ask;
+        return extends;
+    }
+};
+
+// Bid OHLC, every tick counted: the candle MT4 charts show.
+struct BidCandle {
+    template<class H> static void open(H& h, int64_t bid, int64_t){
+        h.last_open = h.last_high = h.last_low = h.last_close = bid;
+    }
+    template<class H> static bool fold(H& h, int64_t bid, int64_t){
+        const bool extends = (bid > h.last_high) || (bid < h.last_low);
+        h.last_high = std::max(h.last_high, bid);
+        h.last_low  = std::min(h.last_low,  bid);
+        h.last_close= bid;
+        return extends;
+    }
+};
+
+// ---- SAR ----
+
+// Very compact SAR (sufficient for trend & flip detection).
+// Written with selects instead of branches: same results, no mispredicts on
+// the extreme/flip tests, which matters for long warm-up loops.
+static inline void sar_step(double& sar, double& ep, double& af, int& dir,
+                            double step, double af_max, double high, double low){
+    if(std::isnan(sar)){ // init
+        dir = +1; // start up by default
+        ep  = high;
+        sar = low;
+        af  = step;
+        return;
+    }
+    const bool up = dir>0;
+    double s = sar + af*(ep - sar);
+    s = up ? std::min(s, low) : std::max(s, high);     // clamp inside
+    const bool extends = up ? (high > ep) : (low < ep);
+    const double nep = extends ? (up ? high : low) : ep;
+    const double naf = extends ? std::min(af + step, af_max) : af;
+    const bool flip = up ? (low < s) : (high > s);
+    sar = flip ? nep  : s;
+    ep  = flip ? (up ? low : high) : nep;
+    af  = flip ? step : naf;
+    dir = flip ? -dir : dir;
+}
+
+// Stepped by every full-path tick with the tick's (and conflated) extremes.
+struct TickSar { static constexpr bool kPerTick = true; };
+// Stepped once per closed candle with its high/low, like MT4's iSAR.
+struct BarSar  { static constexpr bool kPerTick = false; };
+
+// ---- Moving averages (fast/slow EMA on candle closes) ----
+
+static inline double ema_update(double prev, double price, double alpha){
+    if(std::isnan(prev)) return price;
+    return prev + alpha*(price-prev);
+}
+
+// EMA(Fast)/EMA(Slow), alpha = 2/(N+1), seeded with the first close.
+// Ema<1,3> is the spec's "Fast EMA 1 / Slow EMA 3": alphas 1 and 0.5.
+template<int Fast, int Slow>
+struct Ema {
+    static_assert(Fast>=1 && Slow>=1, "EMA periods start at 1");
+    static constexpr double kFast = 2.0/(Fast+1), kSlow = 2.0/(Slow+1);
+    static void update(double& fast, double& slow, double close){
+        fast = ema_update(fast, close, kFast);
+        slow = ema_update(slow, close, kSlow);
+    }
+};
+
+// ---- Golden candle validators ----
+
+struct CandleView { int64_t open, high, low, close; };
+
+// Size >= BaseSL_points (high - low).
+struct RangeCandle {
+    template<class Cfg> static bool valid(const Cfg& cf, const CandleView& k){
+        return k.high - k.low >= cf.BaseSL_points;
+    }
+};
+
+// CGoldenCandleStrategy::CheckEntryConditions: size within
+// [BaseSL, MaxRangeMult*BaseSL] (0 = no cap), a bullish body and
+// body/wick >= BodyToWickPct/100 when there is a wick.
+template<int BodyToWickPct, int MaxRangeMult>
+struct BodyWickCandle {
+    template<class Cfg> static bool valid(const Cfg& cf, const CandleView& k){
+        const int64_t size = k.high - k.low;
+        if(size < cf.BaseSL_points) return false;
+        if(MaxRangeMult>0 && size > (int64_t)MaxRangeMult*cf.BaseSL_points) return false;
+        if(k.open==kNoPrice || k.close <= k.open) return false;
+        const int64_t body = k.close - k.open;
+        const int64_t wick = std::max<int64_t>(0, k.high - k.close) + std::max<int64_t>(0, k.open - k.low);
+        return wick==0 || body*100 >= (int64_t)BodyToWickPct*wick;
+    }
+};
+
+// ---- Level schemas: legs (R:R multiple, qualification) per level ----
+
+struct LevelSchema {
+    int32_t n;
+    int32_t rr[3];
+    int32_t qual[3];
+};
+
+// Level → RR schema (fixed, per spec). Static table: no allocation on plan build.
+struct SpecLevels {
+    static constexpr LevelSchema kFallback = {1, {2}, {LEVEL_1_MAIN}};
+    static constexpr LevelSchema kTable[13] = {
+        kFallback,
+        {1, {2}, {LEVEL_1_MAIN}}, // Level1=2,2=3,...,6=7
+        {1, {3}, {LEVEL_1_MAIN}},
+        {1, {4}, {LEVEL_1_MAIN}},
+        {1, {5}, {LEVEL_1_MAIN}},
+        {1, {6}, {LEVEL_1_MAIN}},
+        {1, {7}, {LEVEL_1_MAIN}},
+        // 7..12 examples per spec. Extend similarly up to 25 as needed.
+        {2, {1,7},   {LEVEL_7_FIRST,LEVEL_7_SECOND}},
+        {2, {3,7},   {LEVEL_8_FIRST,LEVEL_8_SECOND}},
+        {2, {5,7},   {LEVEL_9_FIRST,LEVEL_9_SECOND}},
+        {2, {7,7},   {LEVEL_10_FIRST,LEVEL_10_SECOND}},
+        {3, {3,7,7}, {LEVEL_11_FIRST,LEVEL_11_SECOND,LEVEL_11_THIRD}},
+        {3, {5,7,7}, {LEVEL_12_FIRST,LEVEL_12_SECOND,LEVEL_12_THIRD}},
+    };
+    static const LevelSchema& legs(int level){
+        return (level>=1 && level<=12) ? kTable[level] : kFallback; // fallback
+    }
+};
+
+// One leg at a fixed R:R whatever the level.
+template<int RR>
+struct FixedRr {
+    static constexpr LevelSchema kLeg = {1, {RR}, {LEVEL_1_MAIN}};
+    static const LevelSchema& legs(int){ return kLeg; }
+};
+
+// ---- Bundles ----
+
+template<class Agg, class Sar, class Ma, class Candle, class Schema>
+struct Strategy {
+    using Aggregator = Agg;
+    using SarPolicy  = Sar;
+    using MaPolicy   = Ma;
+    using Validator  = Candle;
+    using Levels     = Schema;
+};
+
+using DefaultStrategy  = Strategy<AskBidCandle, TickSar, Ema<1,3>, RangeCandle, SpecLevels>;
+// Ratio 2.0 and a 10x size cap, as CGoldenCandleStrategy's defaults.
+using BodyWickStrategy = Strategy<AskBidCandle, TickSar, Ema<1,3>, BodyWickCandle<200,10>, SpecLevels>;
+
+} // namespace ea
+
+#ifndef EA_CORE_STRATEGY
+#define EA_CORE_STRATEGY ea::DefaultStrategy
+#endif
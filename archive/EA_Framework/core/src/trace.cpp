@@ -0,0 +1,81 @@
+#include "trace.h"
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+namespace ea {
+
+#if EA_CORE_TRACE
+
+std::atomic<uint32_t> g_trace_state{0};
+std::atomic<uint64_t> g_trace_head{0};
+TraceSlot             g_trace[kTraceSlots];
+
+namespace {
+const char* const kKindName[TR_KIND_COUNT] = {
+    "tick", "candle_close", "signal_eval", "plan_publish",
+    "order_placed", "order_filled", "order_closed", "budget_overrun"
+};
+const char* const kArgName[TR_KIND_COUNT] = {
+    "action", "level", nullptr, "legs", "ticket", "ticket", "ticket", "fn"
+};
+}
+
+int32_t trace_dump(const char* path, double seconds){
+    if(!path) return -1;
+    FILE* f = std::fopen(path, "w");
+    if(!f) return -1;
+
+    const double   cpn  = cycles_per_ns();
+    const uint64_t now  = cycles();
+    const uint64_t head = g_trace_head.load(std::memory_order_acquire);
+    const uint64_t from = head > kTraceSlots ? head - kTraceSlots : 0;
+    const double   win  = seconds * 1e9 * cpn;
+    const uint64_t cut  = (seconds > 0 && win < (double)now) ? now - (uint64_t)win : 0;
+
+    std::fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    std::fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"ea_core\"}}");
+
+    std::vector<int32_t> named;   // contexts that already got a thread_name record
+    int32_t n = 0;
+    for(uint64_t i=from; i<head; ++i){
+        const TraceSlot& s = g_trace[i & (kTraceSlots-1)];
+        const uint64_t s1 = s.seq.load(std::memory_order_acquire);
+        if(s1 != i+1) continue;                      // being written or already overwritten
+        const uint64_t t0  = s.t0.load(std::memory_order_relaxed);
+        const uint64_t dur = s.dur.load(std::memory_order_relaxed);
+        const uint64_t who = s.who.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(s.seq.load(std::memory_order_relaxed) != s1) continue;
+        if(t0 < cut) continue;
+
+        const uint32_t kind   = (uint32_t)(dur & 0xff);
+        const int32_t  handle = (int32_t)(uint32_t)(who >> 32);
+        const int32_t  arg    = (int32_t)(uint32_t)who;
+        if(kind >= TR_KIND_COUNT) continue;
+        if(std::find(named.begin(), named.end(), handle) == named.end()){
+            named.push_back(handle);
+            std::fprintf(f, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                            "\"args\":{\"name\":\"ctx %d\"}}", handle, handle);
+        }
+        std::fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"ea\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                        "\"ts\":%.3f,\"dur\":%.3f",
+                     kKindName[kind], handle,
+                     (double)t0 / cpn / 1000.0, (double)(dur >> 8) / cpn / 1000.0);
+        if(kArgName[kind]) std::fprintf(f, ",\"args\":{\"%s\":%d}}", kArgName[kind], arg);
+        else               std::fprintf(f, "}");
+        ++n;
+    }
+    std::fprintf(f, "\n]}\n");
+    const bool ok = std::ferror(f) == 0;
+    if(std::fclose(f) != 0 || !ok) return -1;
+    return n;
+}
+
+#else
+
+int32_t trace_dump(const char*, double){ return 0; }
+
+#endif
+
+} // namespace ea
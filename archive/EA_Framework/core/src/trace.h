@@ -0,0 +1,90 @@
+#pragma once
+// Span recorder for the tick pipeline: a process-wide ring of fixed-size
+// events, dumped on demand as Chrome trace-event JSON (about:tracing,
+// Perfetto). Recording is off until EA_TraceEnable(1), and is shed while any
+// context is in degraded mode (latency watchdog); compile with EA_CORE_TRACE=0
+// to remove it entirely.
+//
+// Writers claim a slot with one fetch_add and publish it seqlock-style, so
+// any number of contexts/threads can record concurrently without a lock.
+// The ring overwrites the oldest spans; memory is fixed at kTraceSlots*32 B.
+#include <stdint.h>
+#include <atomic>
+#include "latency.h"
+
+#ifndef EA_CORE_TRACE
+#define EA_CORE_TRACE 1
+#endif
+
+namespace ea {
+
+enum TraceKind : uint32_t {
+    TR_TICK = 0,      // EA_OnTick (arg: action)
+    TR_CANDLE,        // M1 candle close (arg: level)
+    TR_SIGNAL,        // golden candle + SAR/MA evaluation
+    TR_PLAN,          // plan construction/publish (arg: legs)
+    TR_ORDER_PLACED,  // arg: ticket
+    TR_ORDER_FILLED,  // arg: ticket
+    TR_ORDER_CLOSED,  // arg: ticket
+    TR_OVERRUN,       // latency budget overrun (arg: EA_StatFn), recorded even when shed
+    TR_KIND_COUNT
+};
+
+static constexpr uint32_t kTraceSlots = 1u<<16; // 2 MB, ~1 min at 1000 ticks/s
+
+struct TraceSlot {
+    std::atomic<uint64_t> seq{0};   // claim index + 1 once published, 0 while written
+    std::atomic<uint64_t> t0{0};    // cycles
+    std::atomic<uint64_t> dur{0};   // cycles<<8 | kind
+    std::atomic<uint64_t> who{0};   // handle<<32 | (uint32)arg
+};
+
+// bit 0: enabled; bits 1..: number of contexts currently shedding.
+// Spans are recorded only when the word is exactly 1, so one load decides.
+extern std::atomic<uint32_t> g_trace_state;
+extern std::atomic<uint64_t> g_trace_head;
+extern TraceSlot             g_trace[kTraceSlots];
+
+inline bool trace_on(){ return g_trace_state.load(std::memory_order_relaxed)==1u; }
+inline bool trace_enabled(){ return (g_trace_state.load(std::memory_order_relaxed) & 1u)!=0; }
+inline void trace_shed(bool on){
+    if(on) g_trace_state.fetch_add(2u, std::memory_order_relaxed);
+    else   g_trace_state.fetch_sub(2u, std::memory_order_relaxed);
+}
+
+inline void trace_record(uint32_t kind, int32_t handle, int32_t arg, uint64_t t0, uint64_t t1){
+    const uint64_t n = g_trace_head.fetch_add(1, std::memory_order_relaxed);
+    TraceSlot& s = g_trace[n & (kTraceSlots-1)];
+    s.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    s.t0.store(t0, std::memory_order_relaxed);
+    s.dur.store(((t1 - t0) << 8) | kind, std::memory_order_relaxed);
+    s.who.store(((uint64_t)(uint32_t)handle << 32) | (uint32_t)arg, std::memory_order_relaxed);
+    s.seq.store(n + 1, std::memory_order_release);
+}
+
+// Records [construction, scope exit) when tracing is on. If argp is given the
+// arg is read at scope exit (e.g. the action the call ended up returning).
+struct TraceSpan {
+    uint64_t       t0;
+    const int32_t* argp;
+    int32_t        handle, arg;
+    uint32_t       kind;
+    TraceSpan(uint32_t k, int32_t h, int32_t a = 0, const int32_t* ap = nullptr)
+        : t0(trace_on() ? cycles() : 0), argp(ap), handle(h), arg(a), kind(k) {}
+    ~TraceSpan(){ if(t0) trace_record(kind, handle, argp ? *argp : arg, t0, cycles()); }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+// Writes the spans of the last `seconds` (all retained spans when <= 0) to
+// path as trace-event JSON. Returns the number of events written, -1 on I/O error.
+int32_t trace_dump(const char* path, double seconds);
+
+} // namespace ea
+
+#if EA_CORE_TRACE
+  #define EA_TRACE(var, kind, handle, ...) ea::TraceSpan var(kind, handle, ##__VA_ARGS__)
+#else
+  #define EA_TRACE(var, kind, handle, ...) do{}while(0)
+#endif
@@ -0,0 +1,47 @@
+#include "alloc_hook.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> g_allocs{0};
+static std::atomic<uint64_t> g_bytes{0};
+
+namespace alloc_hook {
+uint64_t allocations(){ return g_allocs.load(std::memory_order_relaxed); }
+uint64_t bytes(){ return g_bytes.load(std::memory_order_relaxed); }
+}
+
+static void* counted_alloc(std::size_t n, std::size_t align){
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(n, std::memory_order_relaxed);
+    if(n==0) n=1;
+    void* p = nullptr;
+    if(align>alignof(std::max_align_t)){
+        if(posix_memalign(&p, align, n)!=0) p=nullptr;
+    } else {
+        p = std::malloc(n);
+    }
+    if(!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t n){ return counted_alloc(n, 0); }
+void* operator new[](std::size_t n){ return counted_alloc(n, 0); }
+void* operator new(std::size_t n, std::align_val_t a){ return counted_alloc(n, (std::size_t)a); }
+void* operator new[](std::size_t n, std::align_val_t a){ return counted_alloc(n, (std::size_t)a); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    try { return counted_alloc(n, 0); } catch(...) { return nullptr; }
+}
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept {
+    try { return counted_alloc(n, 0); } catch(...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
@@ -0,0 +1,14 @@
+#pragma once
+// Allocation tracking for the ea_core test build: the global operator new/delete
+// are replaced (alloc_hook.cpp) and every allocation bumps a counter, including
+// allocations made from inside libea_core (ELF symbol interposition).
+#include <stdint.h>
+
+namespace alloc_hook {
+uint64_t allocations();   // total operator new calls so far
+uint64_t bytes();         // total bytes requested so far
+}
+
+// Allocations made while evaluating expr; expr's value is discarded.
+#define ALLOCS_IN(expr) ([&]{ uint64_t a0_ = alloc_hook::allocations(); (void)(expr); \
+                              return alloc_hook::allocations() - a0_; }())
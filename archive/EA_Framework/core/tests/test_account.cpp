@@ -0,0 +1,182 @@
+// Account-wide limits and kill switch across contexts, including many
+// contexts filling/closing and ticking concurrently.
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "ea_api.h"
+#include "test_util.h"
+
+namespace {
+
+EA_AccountRisk risk(){ EA_AccountRisk r; EA_GetAccountRisk(&r); return r; }
+
+int32_t make(int32_t level){
+    int32_t h = EA_CreateContext();
+    EA_Init(h, "BTCUSD", 1, 2, 0.01);
+    EA_ApplyLevel(h, level);
+    return h;
+}
+
+int32_t leg_qual(int32_t h){
+    double entry, sl, tp, lots; int32_t qual = 0;
+    EA_PlanOrderGet(h, 0, &entry, &sl, &tp, &lots, &qual);
+    return qual;
+}
+
+}
+
+int main(){
+    int64_t t = 1700000040;   // minute boundary, UTC day 19675
+    const int32_t a = make(1), b = make(1), c = make(1);
+    CHECK(signal(a, t) && signal(b, t) && signal(c, t));
+
+    // Kill switch: every context stops on its next signal.
+    CHECK(EA_KillSwitch(1)==0);
+    CHECK(!signal(a, t) && !signal(b, t));
+    CHECK(risk().vetoes[EA_RISK_KILL_SWITCH]==2);
+    CHECK(EA_KillSwitch(0)==1);
+    CHECK(signal(a, t));
+
+    // Daily loss is summed across contexts and restarts with the UTC day.
+    EA_SetAccountLimit("daily_loss", 100);
+    EA_ReportClosedProfit(a, -60.0);
+    CHECK(signal(b, t));
+    EA_ReportClosedProfit(b, -50.0);
+    CHECK(std::fabs(risk().daily_pnl + 110.0) < 1e-9);
+    CHECK(!signal(a, t) && !signal(c, t));
+    CHECK(risk().vetoes[EA_RISK_DAILY_LOSS]==2);
+    int64_t tomorrow = t + 86400;
+    CHECK(signal(a, tomorrow));
+    EA_SetAccountLimit("daily_loss", 0);
+
+    // Open exposure includes the legs of the plan about to be emitted.
+    EA_SetAccountLimit("max_open_lots", 0.015);
+    EA_OnOrderFilled(a, 101, 60000.0);
+    CHECK(std::fabs(risk().open_lots - 0.01) < 1e-9);
+    CHECK(!signal(b, t));
+    CHECK(risk().vetoes[EA_RISK_EXPOSURE]==1);
+    EA_OnOrderClosed(a, 999, 0, 0);                  // unknown ticket: no change
+    CHECK(std::fabs(risk().open_lots - 0.01) < 1e-9);
+    EA_OnOrderClosed(a, 101, 0, 0);
+    CHECK(risk().open_lots==0.0);
+    CHECK(signal(b, t));
+
+    // The plan reserved its leg: nothing is filled yet, c has no room. The
+    // fill counts at the leg's own lots, whatever the config says since.
+    CHECK(std::fabs(risk().open_lots - 0.01) < 1e-9);
+    CHECK(!signal(c, t));
+    CHECK(risk().vetoes[EA_RISK_EXPOSURE]==2);
+    EA_SetParamDouble(b, "lots", 0.05);
+    EA_OnOrderPlaced(b, 201, leg_qual(b));
+    EA_OnOrderFilled(b, 201, 60000.0);
+    CHECK(std::fabs(risk().open_lots - 0.01) < 1e-9);
+    EA_OnOrderClosed(b, 201, 1, 0);
+    CHECK(risk().open_lots==0.0 && risk().active_contexts==0);
+    EA_SetParamDouble(b, "lots", 0.01);
+    // A cancelled leg gives its reservation back.
+    CHECK(signal(c, t));
+    EA_OnOrderPlaced(c, 202, leg_qual(c));
+    CHECK(!signal(a, t));
+    EA_OnOrderClosed(c, 202, 0, 0);
+    CHECK(risk().open_lots==0.0);
+    CHECK(signal(a, t));
+    EA_SetAccountLimit("max_open_lots", 0);
+
+    // At most one context exposed at level >= 7.
+    EA_SetAccountLimit("high_level", 7);
+    EA_SetAccountLimit("max_high_level", 1);
+    EA_ApplyLevel(a, 7); EA_ApplyLevel(b, 8);
+    EA_OnOrderFilled(a, 102, 60000.0);
+    CHECK(risk().high_level_active==1);
+    CHECK(!signal(b, t));
+    CHECK(signal(c, t));                              // level 1 is not limited
+    CHECK(risk().vetoes[EA_RISK_HIGH_LEVEL]==1);
+    EA_DestroyContext(a);                             // releases its exposure
+    CHECK(risk().high_level_active==0 && risk().active_contexts==0);
+    CHECK(signal(b, t));
+    EA_SetAccountLimit("high_level", 0);
+    EA_DestroyContext(b); EA_DestroyContext(c);
+    CHECK(risk().open_lots==0.0 && risk().active_contexts==0);
+
+    // Concurrency: a limit with room for one plan admits one at a time. A
+    // plan's reservation holds from emission to its leg's close, so the
+    // account never shows more than the limit.
+    for(int mode=0;mode<2;++mode){
+        if(mode==0) EA_SetAccountLimit("max_open_lots", 0.01);
+        else { EA_SetAccountLimit("high_level", 1); EA_SetAccountLimit("max_high_level", 1); }
+        const int kRacers = 4;
+        std::atomic<int> over{0}, plans{0}, ready{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> th;
+        for(int k=0;k<kRacers;++k){
+            th.emplace_back([&, k]{
+                int32_t h = make(1);
+                int64_t tt = 1700000040 + 86400*2;
+                ++ready;
+                while(!go.load()) {}
+                for(int i=0;i<2000;++i){
+                    if(!signal(h, tt)) continue;
+                    ++plans;
+                    const EA_AccountRisk r = risk();
+                    if(r.open_lots > 0.01 + 1e-9 || r.active_contexts > 1) ++over;
+                    const int32_t ticket = 300000 + k*10000 + i;
+                    EA_OnOrderPlaced(h, ticket, leg_qual(h));
+                    EA_OnOrderFilled(h, ticket, 60000.0);
+                    std::this_thread::yield();
+                    EA_OnOrderClosed(h, ticket, 1, 0);
+                }
+                EA_DestroyContext(h);
+            });
+        }
+        while(ready.load()<kRacers) {}
+        go.store(true);
+        for(auto& x : th) x.join();
+        CHECK(over.load()==0);
+        CHECK(plans.load()>0);
+        CHECK(risk().open_lots==0.0 && risk().active_contexts==0);
+        EA_SetAccountLimit("max_open_lots", 0);
+        EA_SetAccountLimit("high_level", 0);
+    }
+
+    // Concurrency: exposure accounting stays exact, and no plan is emitted by
+    // a signal that starts after the kill switch was seen.
+    const int kThreads = 8;
+    std::atomic<int> late_plans{0}, ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> th;
+    for(int k=0;k<kThreads;++k){
+        th.emplace_back([&, k]{
+            int32_t h = make(1 + k%12);
+            int64_t tt = 1700000040;
+            ++ready;
+            while(!go.load()) {}
+            for(int i=0;i<3000;++i){
+                int32_t ticket = k*100000 + i;
+                EA_OnOrderFilled(h, ticket, 60000.0);
+                if(i%3) EA_OnOrderClosed(h, ticket, 0, 0);
+                else    EA_OnOrderClosed(h, ticket-1, 0, 0);   // close an older leg instead
+                const bool killed = risk().kill_switch!=0;
+                if(signal(h, tt) && killed) ++late_plans;
+            }
+            EA_DestroyContext(h);
+        });
+    }
+    while(ready.load()<kThreads) {}
+    go.store(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EA_KillSwitch(1);
+    for(auto& x : th) x.join();
+    EA_KillSwitch(0);
+    CHECK(late_plans.load()==0);
+    EA_AccountRisk r = risk();
+    CHECK(r.open_lots==0.0);
+    CHECK(r.active_contexts==0);
+
+    if(g_fail){ std::printf("%d check(s) failed\n", g_fail); return 1; }
+    std::printf("account ok (%lld kill vetoes)\n", (long long)r.vetoes[EA_RISK_KILL_SWITCH]);
+    return 0;
+}
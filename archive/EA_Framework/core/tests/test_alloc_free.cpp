@@ -0,0 +1,114 @@
+// Replays a synthetic tick stream through the exported API and fails if any
+// steady-state call touches the heap. Setup (first EA_CreateContext, which
+// seeds the context pool, and the first use of a slot, which allocates its
+// bar history) is allowed to allocate; everything after is not.
+#include <cstdio>
+#include <cstdint>
+#include "ea_api.h"
+#include "alloc_hook.h"
+#include "test_util.h"
+
+namespace {
+
+struct CallStat { const char* name; uint64_t calls, allocs; };
+enum Call { C_OnTick, C_PlanCount, C_PlanGet, C_Placed, C_Filled, C_Closed,
+            C_SetFlag, C_SetParam, C_Level, C_ApplyLevel, C_AdviseSL,
+            C_Counters, C_Warmup, C_LastError, C_Create, C_Destroy,
+            C_GetStats, C_ResetStats, C_StageStats, C_Count };
+CallStat g_stats[C_Count] = {
+    {"EA_OnTick",0,0}, {"EA_PlanOrdersCount",0,0}, {"EA_PlanOrderGet",0,0},
+    {"EA_OnOrderPlaced",0,0}, {"EA_OnOrderFilled",0,0}, {"EA_OnOrderClosed",0,0},
+    {"EA_SetFlag",0,0}, {"EA_SetParamDouble",0,0}, {"EA_CurrentLevel",0,0},
+    {"EA_ApplyLevel",0,0}, {"EA_AdviseSL",0,0}, {"EA_TickCounters",0,0},
+    {"EA_Warmup",0,0}, {"EA_LastError",0,0}, {"EA_CreateContext",0,0},
+    {"EA_DestroyContext",0,0}, {"EA_GetStats",0,0}, {"EA_ResetStats",0,0},
+    {"EA_GetStageStats",0,0},
+};
+#define TRACK(call, expr) do { ++g_stats[call].calls; g_stats[call].allocs += ALLOCS_IN(expr); } while(0)
+
+// Deterministic BTCUSD-like random walk (digits=2): volatile enough to print
+// golden candles (>=10000 points per minute) regularly.
+struct TickGen {
+    Walk     w{12345, 60000.0};
+    int64_t  t = 1700000000, n = 0;
+    void next(double& bid, double& ask, int64_t& time){
+        bid = w.step(); ask = bid + 0.20;
+        time = t + (n++)/40; // 40 ticks per minute
+    }
+};
+
+}
+
+int main(){
+    // ---- setup (may allocate) ----
+    int32_t h = EA_CreateContext();
+    if(h<=0){ std::printf("FAIL: EA_CreateContext\n"); return 1; }
+    EA_Init(h, "BTCUSD", 42, 2, 0.01);
+    EA_TraceEnable(1);   // span recording must stay heap-free too
+    EA_DestroyContext(EA_CreateContext());   // first use of the churn slot
+
+    // ---- steady state: nothing below may allocate ----
+    int64_t time[64]; double o[64], hi[64], lo[64], cl[64];
+    for(int i=0;i<64;++i){ time[i]=1699990000+60*i; o[i]=cl[i]=60000+i; hi[i]=cl[i]+150; lo[i]=cl[i]-150; }
+    TRACK(C_Warmup, EA_Warmup(h, time, o, hi, lo, cl, 64));
+
+    // Context churn is served from the pool.
+    for(int i=0;i<1000;++i){
+        int32_t tmp = 0;
+        TRACK(C_Create, tmp = EA_CreateContext());
+        TRACK(C_Destroy, EA_DestroyContext(tmp));
+    }
+
+    TickGen gen;
+    int64_t plans = 0, legs = 0, max_legs = 0;
+    int32_t ticket = 1000;
+    for(int64_t i=0;i<3000000;++i){
+        double bid, ask; int64_t t; int32_t action = 0;
+        gen.next(bid, ask, t);
+        TRACK(C_OnTick, EA_OnTick(h, bid, ask, t, 0, &action));
+        if(action==EA_PLAN_ORDERS){
+            ++plans;
+            int32_t n = 0;
+            TRACK(C_PlanCount, n = EA_PlanOrdersCount(h));
+            legs += n; if(n>max_legs) max_legs = n;
+            for(int32_t k=0;k<n;++k){
+                double e, sl, tp, lots; int32_t q;
+                TRACK(C_PlanGet, EA_PlanOrderGet(h, k, &e, &sl, &tp, &lots, &q));
+                TRACK(C_Placed, EA_OnOrderPlaced(h, ++ticket, q));
+                TRACK(C_Filled, EA_OnOrderFilled(h, ticket, e));
+            }
+            // Walk the level ladder so multi-leg schemas (levels 7..12) are emitted too.
+            bool tp_hit = (plans % 13)!=0;
+            TRACK(C_Closed, EA_OnOrderClosed(h, ticket, tp_hit?1:0, tp_hit?0:1));
+            int32_t lvl = 0;
+            TRACK(C_Level, lvl = EA_CurrentLevel(h));
+            if(lvl>=12 && (plans % 5)==0) TRACK(C_ApplyLevel, EA_ApplyLevel(h, 7));
+        }
+        if((i % 250000)==0){
+            double new_sl; int32_t modify; int64_t full, conf;
+            TRACK(C_SetFlag,  EA_SetFlag(h, "conflate", (int32_t)((i/250000)&1)));
+            TRACK(C_SetParam, EA_SetParamDouble(h, "conflate_points", 25.0));
+            TRACK(C_AdviseSL, EA_AdviseSL(h, bid, &new_sl, &modify));
+            TRACK(C_Counters, EA_TickCounters(h, &full, &conf));
+            TRACK(C_LastError, EA_LastError(h));
+            EA_Stats st;
+            TRACK(C_GetStats, EA_GetStats(h, &st));
+            EA_StageStats ps;
+            TRACK(C_StageStats, EA_GetStageStats(h, &ps));
+            if(i==1500000) TRACK(C_ResetStats, EA_ResetStats(h));
+        }
+    }
+    EA_DestroyContext(h);
+
+    bool ok = true;
+    std::printf("%-20s %12s %10s\n", "call", "calls", "allocs");
+    for(const CallStat& cs : g_stats){
+        std::printf("%-20s %12llu %10llu\n", cs.name, (unsigned long long)cs.calls, (unsigned long long)cs.allocs);
+        if(cs.allocs) ok = false;
+    }
+    std::printf("plans=%lld legs=%lld max_legs=%lld\n", (long long)plans, (long long)legs, (long long)max_legs);
+    if(plans==0 || max_legs<3){ std::printf("FAIL: stream did not exercise plan emission\n"); return 1; }
+    if(!ok){ std::printf("FAIL: steady-state calls allocated\n"); return 1; }
+    std::printf("PASS\n");
+    return 0;
+}
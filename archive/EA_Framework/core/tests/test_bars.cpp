@@ -0,0 +1,280 @@
+// Multi-timeframe bars: M1..H1 OHLCV from live ticks against a brute-force
+// aggregation, the week-deep M1 history (columns, wraparound), warmup seeding
+// (and its SAR/EMA state against live ticks), and the higher-timeframe SAR
+// confirmation.
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "ea_api.h"
+#include "test_util.h"
+
+namespace {
+
+const int64_t kTfSec[EA_TF_COUNT] = { 60, 300, 900, 3600 };
+
+bool same(const EA_Bar& a, const EA_Bar& b){
+    return a.time==b.time && a.ticks==b.ticks &&
+           std::fabs(a.open-b.open)<1e-9 && std::fabs(a.high-b.high)<1e-9 &&
+           std::fabs(a.low-b.low)<1e-9   && std::fabs(a.close-b.close)<1e-9;
+}
+
+int32_t make(){
+    int32_t h = EA_CreateContext();
+    EA_Init(h, "BTCUSD", 1, 2, 0.01);
+    return h;
+}
+
+// n M1 bars ending just before t, moving by step per bar.
+void warmup(int32_t h, int64_t t, int32_t n, double start, double step){
+    std::vector<int64_t> tm(n);
+    std::vector<double> o(n), hi(n), lo(n), cl(n);
+    for(int32_t i=0;i<n;++i){
+        tm[i] = t - (int64_t)(n-i)*60;
+        o[i]  = start + step*i;
+        cl[i] = o[i] + step;
+        hi[i] = std::max(o[i], cl[i]) + 1.0;
+        lo[i] = std::min(o[i], cl[i]) - 1.0;
+    }
+    CHECK(EA_Warmup(h, tm.data(), o.data(), hi.data(), lo.data(), cl.data(), n)==n);
+}
+
+}
+
+int main(){
+    // Live ticks: random walk over ~3h with gaps, some paused/in-trade ticks.
+    {
+        const int32_t h = make();
+        std::mt19937 rng(7);
+        std::vector<EA_Bar> ref[EA_TF_COUNT];
+        std::vector<int32_t> smin, smax;   // per M1 bar, points
+        int64_t t = 1700000000;
+        double px = 60000.0;
+        int32_t a = 0;
+        for(int32_t i=0;i<20000;++i){
+            t += (rng()%40==0) ? 200 + rng()%400 : rng()%3;
+            px = std::round((px + (double)((int32_t)(rng()%201) - 100)/100.0)*100)/100;
+            EA_SetFlag(h, "paused", rng()%50==0);
+            const int32_t spread = 10 + (int32_t)(rng()%50);
+            EA_OnTick(h, px, px + spread/100.0, t, rng()%30==0, &a);
+            for(int32_t f=0;f<EA_TF_COUNT;++f){
+                const int64_t bt = (t/kTfSec[f])*kTfSec[f];
+                std::vector<EA_Bar>& r = ref[f];
+                if(r.empty() || r.back().time!=bt) r.push_back(EA_Bar{bt, px, px, px, px, 0});
+                EA_Bar& b = r.back();
+                b.high = std::max(b.high, px); b.low = std::min(b.low, px); b.close = px; ++b.ticks;
+            }
+            if(smin.size()<ref[EA_TF_M1].size()){ smin.push_back(spread); smax.push_back(spread); }
+            smin.back() = std::min(smin.back(), spread); smax.back() = std::max(smax.back(), spread);
+        }
+        EA_SetFlag(h, "paused", 0);
+        for(int32_t f=0;f<EA_TF_COUNT;++f){
+            EA_Bar out[80];
+            const int32_t want = (int32_t)std::min<size_t>(ref[f].size(), f==EA_TF_M1 ? 80 : 65);
+            CHECK(EA_GetBars(h, f, 0, 80, out)==want);
+            for(int32_t k=0;k<want;++k) CHECK(same(out[k], ref[f][ref[f].size()-1-k]));
+            EA_Bar one;
+            CHECK(EA_GetBars(h, f, 3, 1, &one)==1 && same(one, out[3]));
+            if(f!=EA_TF_M1) CHECK(EA_GetBars(h, f, 65, 1, &one)==0 || ref[f].size()<=65);
+        }
+
+        // History columns: closed M1 bars, oldest first
+        const std::vector<EA_Bar>& m1 = ref[EA_TF_M1];
+        const int32_t closed = (int32_t)m1.size()-1;
+        CHECK(EA_HistoryCount(h)==closed);
+        std::vector<int64_t> tm(closed), tk(closed);
+        std::vector<double> op(closed), hi(closed), lo(closed), cl(closed);
+        std::vector<int32_t> s0(closed), s1(closed);
+        CHECK(EA_HistoryCopy(h, 0, closed+10, tm.data(), op.data(), hi.data(), lo.data(), cl.data(),
+                             tk.data(), s0.data(), s1.data())==closed);
+        bool match = true;
+        for(int32_t k=0;k<closed;++k){
+            const EA_Bar got{tm[k], op[k], hi[k], lo[k], cl[k], tk[k]};
+            match = match && same(got, m1[k]) && s0[k]==smin[k] && s1[k]==smax[k];
+        }
+        CHECK(match);
+        CHECK(EA_HistoryCopy(h, 5, 3, tm.data(), nullptr, nullptr, nullptr, cl.data(), nullptr, nullptr, nullptr)==3);
+        CHECK(tm[2]==m1[closed-6].time && tm[0]==m1[closed-8].time && std::fabs(cl[2]-m1[closed-6].close)<1e-9);
+        CHECK(EA_HistoryCopy(h, closed, 5, tm.data(), nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr)==0);
+        CHECK(EA_HistoryCopy(h, -1, 5, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr)==-2);
+        double sar = 0; int32_t dir = 0;
+        CHECK(EA_GetTfSar(h, EA_TF_H1, &sar, &dir)==1 && (dir==1 || dir==-1) && sar>0);
+        CHECK(EA_GetBars(h, EA_TF_COUNT, 0, 1, nullptr)==-2);
+        CHECK(EA_GetBars(h, EA_TF_M1, -1, 1, nullptr)==-2);
+        CHECK(EA_GetTfSar(h, -1, &sar, &dir)==-2);
+        CHECK(EA_GetBars(-5, EA_TF_M1, 0, 0, nullptr)==-1);
+        EA_DestroyContext(h);
+    }
+
+    // A week and a bit of one-tick minutes: the history keeps the newest week.
+    {
+        const int32_t h = make();
+        const int32_t week = 7*24*60, n = week + 300;
+        int32_t a = 0;
+        for(int32_t i=0;i<=n;++i) EA_OnTick(h, 1000.0 + i%997, 1000.5 + i%997, 1700000040 + (int64_t)i*60, 0, &a);
+        CHECK(EA_HistoryCount(h)==week);
+        std::vector<int64_t> tm(week);
+        std::vector<double> cl(week);
+        CHECK(EA_HistoryCopy(h, 0, week, tm.data(), nullptr, nullptr, nullptr, cl.data(), nullptr, nullptr, nullptr)==week);
+        bool match = true;
+        for(int32_t k=0;k<week;++k){
+            const int32_t i = n - week + k;   // minute index of the bar
+            match = match && tm[k]==1700000040 + (int64_t)i*60 && std::fabs(cl[k]-(1000.0 + i%997))<1e-9;
+        }
+        CHECK(match);
+        EA_Bar b;
+        CHECK(EA_GetBars(h, EA_TF_M1, week, 1, &b)==1 && b.time==tm[0]);
+        CHECK(EA_GetBars(h, EA_TF_M1, week+1, 1, &b)==0);
+        EA_Reset(h);
+        CHECK(EA_HistoryCount(h)==0);
+        EA_DestroyContext(h);
+    }
+
+    // Warmup seeds the bars (the last one stays forming) and the higher SARs.
+    const int64_t t0 = 1700006400;   // hour boundary
+    {
+        const int32_t h = make();
+        double sar = 0; int32_t dir = 0;
+        CHECK(EA_GetTfSar(h, EA_TF_M5, &sar, &dir)==0);
+        warmup(h, t0, 120, 50000.0, 10.0);
+        EA_Bar b[2];
+        CHECK(EA_GetBars(h, EA_TF_M1, 0, 2, b)==2);
+        CHECK(b[0].time==t0-60 && std::fabs(b[0].open-51190.0)<1e-9 && std::fabs(b[0].close-51200.0)<1e-9 && b[0].ticks==0);
+        CHECK(b[1].time==t0-120 && std::fabs(b[1].open-51180.0)<1e-9);
+        CHECK(EA_GetBars(h, EA_TF_H1, 0, 2, b)==2);
+        CHECK(b[0].time==t0-3600 && std::fabs(b[0].open-50600.0)<1e-9 && std::fabs(b[0].high-51201.0)<1e-9);
+        CHECK(b[1].time==t0-7200 && std::fabs(b[1].low-49999.0)<1e-9 && std::fabs(b[1].close-50600.0)<1e-9);
+        CHECK(EA_GetTfSar(h, EA_TF_M5, &sar, &dir)==1 && dir==1 && sar<51200.0);
+        // A live tick in the next minute closes the last warmup bar
+        int32_t a = 0;
+        EA_OnTick(h, 51210.0, 51210.5, t0+1, 0, &a);
+        CHECK(EA_GetBars(h, EA_TF_M1, 0, 2, b)==2 && b[0].time==t0 && b[0].ticks==1 && b[1].time==t0-60);
+        CHECK(EA_GetBars(h, EA_TF_H1, 0, 1, b)==1 && b[0].time==t0 && std::fabs(b[0].open-51210.0)<1e-9);
+        EA_DestroyContext(h);
+    }
+
+    // Warmup leaves SAR and EMAs as live ticks would. The live twin gets two
+    // ticks per bar: one spanning it (bid low, ask high) that steps the SAR
+    // and closes the previous candle into the EMAs, and a conflated one at the
+    // close. Bars are gapless, so the close's extreme folded into the next
+    // step is inside that bar. Both then take the same live ticks. Warmup
+    // replays only the newest week of the 9 days, so the twin gets that week.
+    {
+        const int32_t n = 9*24*60, week = 7*24*60 + 1;
+        std::vector<int64_t> tm(n);
+        std::vector<double> o(n), hi(n), lo(n), cl(n);
+        Walk w{31, 50000.0};
+        for(int32_t i=0;i<n;++i){
+            tm[i] = t0 + (int64_t)i*60;
+            o[i]  = i ? cl[i-1] : w.px;
+            cl[i] = w.step(200, 0.1);
+            hi[i] = std::max(o[i], cl[i]) + 0.01*(w.s>>8 & 255);
+            lo[i] = std::min(o[i], cl[i]) - 0.01*(w.s>>16 & 255);
+        }
+        const int32_t warm = make(), live = make();
+        CHECK(EA_Warmup(warm, tm.data(), o.data(), hi.data(), lo.data(), cl.data(), n)==week);
+        EA_SetFlag(live, "conflate", 1);
+        EA_SetParamDouble(live, "conflate_points", 1e9);
+        int32_t a = 0, plans = 0;
+        for(int32_t i=n-week;i<n;++i){
+            EA_OnTick(live, lo[i], hi[i], tm[i], 0, &a);    plans += a==EA_PLAN_ORDERS;
+            EA_OnTick(live, cl[i], cl[i], tm[i]+30, 0, &a); plans += a==EA_PLAN_ORDERS;
+        }
+        CHECK(plans==0);   // no bar spans BaseSL
+        EA_SetFlag(live, "conflate", 0);
+        double s0 = 0, s1 = 0; int32_t d0 = 0, d1 = 0;
+        CHECK(EA_GetTfSar(warm, EA_TF_M1, &s0, &d0)==1 && EA_GetTfSar(live, EA_TF_M1, &s1, &d1)==1);
+        CHECK(s0==s1 && d0==d1);
+
+        EA_Funnel f0, f1, before;
+        EA_GetFunnel(live, &before);
+        int64_t t = t0 + (int64_t)n*60;
+        bool same_path = true;
+        for(int32_t i=0;i<1200;++i){   // 20 minutes
+            const double px = w.step(20, 0.05);
+            int32_t a0 = 0, a1 = 0;
+            EA_OnTick(warm, px, px+0.2, t+i, 0, &a0);
+            EA_OnTick(live, px, px+0.2, t+i, 0, &a1);
+            EA_GetTfSar(warm, EA_TF_M1, &s0, &d0);
+            EA_GetTfSar(live, EA_TF_M1, &s1, &d1);
+            same_path = same_path && a0==a1 && s0==s1 && d0==d1;
+        }
+        CHECK(same_path);
+        t += 1200;
+        CHECK(golden_candle(warm, t, w.px) && golden_candle(live, t, w.px));
+        double e[2] = {}, tp[2] = {}, sl, lots; int32_t q[2] = {};
+        CHECK(EA_PlanOrderGet(warm, 0, &e[0], &sl, &tp[0], &lots, &q[0])==1);
+        CHECK(EA_PlanOrderGet(live, 0, &e[1], &sl, &tp[1], &lots, &q[1])==1);
+        CHECK(e[0]==e[1] && tp[0]==tp[1] && q[0]==q[1]);
+        EA_GetFunnel(warm, &f0);
+        EA_GetFunnel(live, &f1);
+        bool same_funnel = f0.total[EA_FUNNEL_CANDLES]>=20;
+        for(int32_t g=0;g<EA_FUNNEL_COUNT;++g) same_funnel = same_funnel && f0.total[g]==f1.total[g]-before.total[g];
+        CHECK(same_funnel);
+        EA_DestroyContext(warm); EA_DestroyContext(live);
+    }
+
+    // Higher-timeframe SAR confirmation.
+    {
+        const int32_t up = make(), down = make(), none = make();
+        warmup(up,   t0, 120, 50000.0,  10.0);
+        warmup(down, t0, 120, 53000.0, -10.0);
+        EA_SetFlag(up,   "htf_sar_confirm", EA_TF_M15);
+        EA_SetFlag(down, "htf_sar_confirm", EA_TF_M15);
+        EA_SetFlag(none, "htf_sar_confirm", EA_TF_H1);   // no H1 bar closed yet
+        int64_t t = t0;
+        CHECK(signal(up, t, 51300.0));
+        t = t0;
+        CHECK(!signal(down, t, 51300.0));
+        t = t0;
+        CHECK(!signal(none, t, 51300.0));
+        EA_SetFlag(down, "htf_sar_confirm", 0);
+        CHECK(signal(down, t, 51300.0));
+        EA_DestroyContext(up); EA_DestroyContext(down); EA_DestroyContext(none);
+    }
+
+    // Range bars: the signal candle closes on its bid range, not on the minute,
+    // and on the tick that completes it.
+    {
+        const int32_t rb = make(), tb = make();
+        EA_SetParamDouble(rb, "range_bar_points", 15000);
+        const int64_t t = 1700000040;
+        struct { int64_t dt; double bid; } ticks[] = {
+            {0, 60000.0}, {5, 60000.0}, {70, 60140.0},     // new minute, bid range 140.0 < 150
+            {100, 60149.9},                                // ask high - bid low 150.1: spread doesn't count
+            {130, 60150.0},                                // bid range 150.0: completes and closes the bar
+            {131, 60151.0},                                // opens the next bar
+        };
+        const int32_t n = (int32_t)(sizeof(ticks)/sizeof(ticks[0]));
+        int32_t plans_rb[6] = {}, plans_tb = 0;
+        for(int32_t i=0;i<n;++i){
+            int32_t a = 0;
+            EA_OnTick(rb, ticks[i].bid, ticks[i].bid + 0.2, t + ticks[i].dt, 0, &a); plans_rb[i] = a;
+            EA_OnTick(tb, ticks[i].bid, ticks[i].bid + 0.2, t + ticks[i].dt, 0, &a); plans_tb += a==EA_PLAN_ORDERS;
+        }
+        CHECK(plans_rb[0]==0 && plans_rb[1]==0 && plans_rb[2]==0 && plans_rb[3]==0 && plans_rb[5]==0);
+        CHECK(plans_rb[4]==EA_PLAN_ORDERS);
+        double e = 0, sl = 0, tp = 0, lots = 0; int32_t q = 0;
+        CHECK(EA_PlanOrderGet(rb, 0, &e, &sl, &tp, &lots, &q)==1 && std::fabs(e - (60150.2 + 35.0))<1e-9);
+        CHECK(plans_tb==0);   // no M1 candle spans 100 points
+        // The clock-based bars are the same in both modes
+        EA_Bar x[3], y[3];
+        CHECK(EA_GetBars(rb, EA_TF_M1, 0, 3, x)==3 && EA_GetBars(tb, EA_TF_M1, 0, 3, y)==3);
+        CHECK(same(x[0], y[0]) && same(x[1], y[1]) && same(x[2], y[2]));
+        // The bar opened by the last tick closes on its own completing tick
+        int32_t a = 0;
+        EA_OnTick(rb, 60200.0, 60200.2, t + 140, 0, &a);   // bid range 49.0 from the 60151.0 open
+        CHECK(a==0);
+        EA_OnTick(rb, 60050.0, 60050.2, t + 150, 0, &a);   // bid range 150.0: closes, plan or not
+        CHECK(a!=0 || EA_PlanOrdersCount(rb)==0);
+        int64_t full = 0, conflated = 0;
+        EA_TickCounters(rb, &full, &conflated);
+        CHECK(full==n+2 && conflated==0);
+        EA_DestroyContext(rb); EA_DestroyContext(tb);
+    }
+
+    if(g_fail) return 1;
+    std::printf("bars: ok\n");
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Batched sweeps: every lane of a batch must plan and move its SAR exactly as
+// a scalar context with the same settings, for each kernel the CPU has.
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "ea_api.h"
+#include "test_util.h"
+
+namespace {
+
+const int32_t kLanes = 37;   // not a multiple of the vector width
+
+struct Params { double base_sl, offset, step, amax; int32_t level; };
+
+Params params(int32_t i){
+    return { 2000.0 + 500.0*(i%9), 1000.0*(i%4), 0.001*(1 + i%5), 0.05*(1 + i%4), 1 + (i*5)%13 };
+}
+
+// Walk with bursts, 600 ticks per minute.
+struct Tick { int64_t t; double bid, ask; };
+std::vector<Tick> walk(int32_t n){
+    std::vector<Tick> v;
+    Walk w{777, 60000.0};
+    for(int32_t i=0;i<n;++i){
+        const double px = w.step((i/3000)%3==0 ? 400 : 60, 0.01);
+        v.push_back({ 1700000040 + i/10, px, px + 0.01*(10 + (w.s>>8)%20) });
+    }
+    return v;
+}
+
+void run(int32_t isa, const std::vector<Tick>& ticks){
+    const int32_t b = EA_BatchCreate(kLanes, 2, 0.01, isa);
+    CHECK(b>0);
+    if(b<=0) return;
+    const int32_t got = EA_BatchIsa(b);
+    CHECK(got>=EA_ISA_SCALAR && got<=isa);
+    std::vector<int32_t> h(kLanes);
+    for(int32_t i=0;i<kLanes;++i){
+        const Params p = params(i);
+        h[i] = EA_CreateContext();
+        EA_Init(h[i], "BTCUSD", 1, 2, 0.01);
+        EA_SetParamDouble(h[i], "base_sl_points", p.base_sl);
+        EA_SetParamDouble(h[i], "entry_offset_points", p.offset);
+        EA_SetParamDouble(h[i], "sar_step", p.step);
+        EA_SetParamDouble(h[i], "sar_max", p.amax);
+        EA_ApplyLevel(h[i], p.level);
+        CHECK(EA_BatchSetParam(b, i, "base_sl_points", p.base_sl)==1);
+        CHECK(EA_BatchSetParam(b, i, "entry_offset_points", p.offset)==1);
+        CHECK(EA_BatchSetParam(b, i, "sar_step", p.step)==1);
+        CHECK(EA_BatchSetParam(b, i, "sar_max", p.amax)==1);
+        CHECK(EA_BatchSetParam(b, i, "level", p.level)==1);
+    }
+
+    int64_t plans = 0, mismatches = 0;
+    for(const Tick& tk : ticks){
+        const int32_t np = EA_BatchOnTick(b, tk.bid, tk.ask, tk.t);
+        int32_t scalar_np = 0;
+        for(int32_t i=0;i<kLanes;++i){
+            int32_t a = 0;
+            EA_OnTick(h[i], tk.bid, tk.ask, tk.t, 0, &a);
+            EA_BatchLane l;
+            EA_BatchGetLane(b, i, &l);
+            double sar = 0; int32_t dir = 0;
+            EA_GetTfSar(h[i], EA_TF_M1, &sar, &dir);
+            bool ok = sar==l.sar && dir==l.dir;   // bit-exact
+            if(a==EA_PLAN_ORDERS){
+                ++scalar_np;
+                double e = 0, sl = 0, tp = 0, lots = 0; int32_t q = 0;
+                ok = ok && l.last_plan_time==tk.t && l.legs==EA_PlanOrdersCount(h[i]);
+                for(int32_t j=0; ok && j<l.legs; ++j){
+                    EA_PlanOrderGet(h[i], j, &e, &sl, &tp, &lots, &q);
+                    ok = e==l.entry && sl==l.sl && tp==l.tp[j];
+                }
+            }
+            if(!ok) ++mismatches;
+        }
+        CHECK(np==scalar_np);
+        plans += np;
+    }
+    CHECK(mismatches==0);
+    CHECK(plans>100);
+    EA_BatchLane l;
+    CHECK(EA_BatchGetLane(b, kLanes, &l)==-2);
+    CHECK(EA_BatchSetParam(b, -1, "sar_max", 0.3)==1);
+    CHECK(EA_BatchSetParam(b, 0, "lots", 1)==0);
+    CHECK(EA_BatchSetParam(b, 0, "level", 26)==-2);
+    for(int32_t x : h) EA_DestroyContext(x);
+    EA_BatchDestroy(b);
+    CHECK(EA_BatchIsa(b)==-1);
+    std::printf("  isa %d: %lld lane plans\n", got, (long long)plans);
+}
+
+}
+
+int main(){
+    const std::vector<Tick> ticks = walk(30000);
+    run(EA_ISA_SCALAR, ticks);
+    run(EA_ISA_AVX2, ticks);
+    run(EA_ISA_AVX512, ticks);
+    CHECK(EA_BatchCreate(0, 2, 0.01, EA_ISA_AUTO)==-2);
+    CHECK(EA_BatchCreate(8, 2, 0.01, 7)==-2);
+    CHECK(EA_BatchOnTick(99, 1, 1, 1)==-1);
+    // Each run above reused slot 1; a smaller batch in it starts from scratch
+    const int32_t r = EA_BatchCreate(3, 2, 0.01, EA_ISA_AUTO);
+    EA_BatchLane l{};
+    CHECK(r==1 && EA_BatchGetLane(r, 2, &l)==1 && l.plans==0 && l.dir==0 && l.sar==0 && l.legs==0);
+    CHECK(EA_BatchGetLane(r, 3, &l)==-2);
+    EA_BatchDestroy(r);
+    if(g_fail) return 1;
+    std::printf("batch: ok\n");
+    return 0;
+}
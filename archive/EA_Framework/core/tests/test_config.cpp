@@ -0,0 +1,123 @@
+// Config snapshots: runtime keys, config file load/poll (all-or-nothing), and
+// a writer thread swapping whole files while the tick thread emits plans:
+// every plan must come from one snapshot.
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <sys/stat.h>
+#include <utime.h>
+#include "ea_api.h"
+#include "test_util.h"
+
+namespace {
+
+struct Leg { double entry, sl, tp, lots; };
+Leg leg(int32_t h){
+    Leg l{}; int32_t q = 0;
+    EA_PlanOrderGet(h, 0, &l.entry, &l.sl, &l.tp, &l.lots, &q);
+    return l;
+}
+
+void write_file(const char* path, const char* text, time_t mtime){
+    FILE* f = std::fopen(path, "w");
+    std::fputs(text, f);
+    std::fclose(f);
+    utimbuf tb{mtime, mtime};
+    utime(path, &tb);
+}
+
+}
+
+int main(){
+    const double base = 60000.0, close = base + 190.2;
+    int64_t t = 1700000040;
+    const int32_t h = EA_CreateContext();
+    EA_Init(h, "BTCUSD", 1, 2, 0.01);
+
+    // Defaults: SL 10000 points under an entry 3500 points above the close
+    CHECK(signal(h, t, base));
+    Leg l = leg(h);
+    CHECK(std::fabs(l.entry - (close+35.0))<1e-9 && std::fabs(l.entry-l.sl-100.0)<1e-9 && l.lots==0.01);
+
+    // Runtime keys publish a new snapshot; bad values are ignored
+    EA_SetParamDouble(h, "base_sl_points", 5000);
+    EA_SetParamDouble(h, "lots", -1);
+    CHECK(signal(h, t, base));
+    l = leg(h);
+    CHECK(std::fabs(l.entry-l.sl-50.0)<1e-9 && l.lots==0.01);
+    EA_SetFlag(h, "paused", 1);
+    CHECK(!signal(h, t, base));
+    EA_SetFlag(h, "paused", 0);
+
+    // Config file: applied as a whole, reloaded on change, rejected as a whole
+    const char* path = "test_config.cfg";
+    write_file(path, "# strategy\nbase_sl_points = 8000\nentry_offset_points=1000\n\nlots=0.02\n", 1000000);
+    CHECK(EA_ConfigLoad(h, path)==1);
+    CHECK(EA_ConfigPoll(h)==0);
+    CHECK(signal(h, t, base));
+    l = leg(h);
+    CHECK(std::fabs(l.entry-(close+10.0))<1e-9 && std::fabs(l.entry-l.sl-80.0)<1e-9 && l.lots==0.02);
+
+    write_file(path, "base_sl_points=6000\nlots=0.03\n", 1000060);
+    CHECK(EA_ConfigPoll(h)==1);
+    CHECK(EA_ConfigPoll(h)==0);
+    CHECK(signal(h, t, base));
+    l = leg(h);
+    CHECK(std::fabs(l.entry-(close+10.0))<1e-9 && std::fabs(l.entry-l.sl-60.0)<1e-9 && l.lots==0.03);
+
+    write_file(path, "lots=0.05\nbase_sl_point=7000\n", 1000120);
+    CHECK(EA_ConfigPoll(h)==-2);
+    CHECK(std::strstr(EA_LastError(h), "line 2")!=nullptr);
+    CHECK(EA_ConfigPoll(h)==0);                      // same file: not retried
+    write_file(path, "lots=abc\n", 1000180);
+    CHECK(EA_ConfigPoll(h)==-2);
+    CHECK(signal(h, t, base));
+    l = leg(h);
+    CHECK(std::fabs(l.entry-l.sl-60.0)<1e-9 && l.lots==0.03);   // previous snapshot kept
+    EA_SetParamDouble(h, "lots", -1.0);               // rejected values change nothing
+    EA_SetParamDouble(h, "base_sl_points", 0.0);
+    CHECK(signal(h, t, base));
+    l = leg(h);
+    CHECK(std::fabs(l.entry-l.sl-60.0)<1e-9 && l.lots==0.03);
+    CHECK(EA_ConfigLoad(h, "no_such_file.cfg")==-2);
+    CHECK(EA_ConfigLoad(-3, path)==-1);
+
+    // A writer thread alternates two whole files while plans are emitted.
+    const char* pa = "test_config_a.cfg";
+    const char* pb = "test_config_b.cfg";
+    write_file(pa, "entry_offset_points=1000\nbase_sl_points=4000\nlots=0.01\n", 1000000);
+    write_file(pb, "entry_offset_points=2000\nbase_sl_points=9000\nlots=0.02\n", 1000000);
+    std::atomic<bool> stop{false};
+    std::atomic<int64_t> loads{0};
+    std::thread writer([&]{
+        for(int64_t i=0; !stop.load(std::memory_order_relaxed); ++i){
+            EA_ConfigLoad(h, (i&1) ? pb : pa);
+            loads.fetch_add(1, std::memory_order_relaxed);
+            if((i&63)==0) std::this_thread::yield();
+        }
+    });
+    while(loads.load()==0) std::this_thread::yield();
+    int32_t plans = 0, torn = 0;
+    for(int32_t i=0;i<20000;++i){
+        if(!signal(h, t, base)) continue;
+        ++plans;
+        l = leg(h);
+        const bool a = std::fabs(l.entry-(close+10.0))<1e-9 && std::fabs(l.entry-l.sl-40.0)<1e-9 && l.lots==0.01;
+        const bool b = std::fabs(l.entry-(close+20.0))<1e-9 && std::fabs(l.entry-l.sl-90.0)<1e-9 && l.lots==0.02;
+        if(!a && !b) ++torn;
+    }
+    stop.store(true);
+    writer.join();
+    CHECK(plans==20000);
+    CHECK(torn==0);
+    CHECK(loads.load()>1);
+
+    EA_DestroyContext(h);
+    std::remove(path); std::remove(pa); std::remove(pb);
+    if(g_fail) return 1;
+    std::printf("config: ok (%d plans, %lld reloads)\n", plans, (long long)loads.load());
+    return 0;
+}
@@ -0,0 +1,112 @@
+// Tick conflation: a scripted feed run with and without "conflate". The
+// candle must stay exact (its extremes come from conflated ticks), the
+// counters must split the ticks by path, and the SAR must pick up the
+// extremes of the ticks it skipped at the next full-path tick.
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include "ea_api.h"
+#include "test_util.h"
+
+namespace {
+
+struct Tick { int64_t dt; double bid, ask; bool full; };   // full: expected path with conflation
+
+// A golden candle whose range (ask high - bid low = 100.10) only reaches
+// BaseSL through two conflated ticks, then the next candle's first tick.
+// With conflate_points=100 (1.00) a tick is skipped unless it extends the
+// candle and its mid moves 1.00 or more from the last full-path tick.
+const Tick kCandle[] = {
+    {  0, 60000.00, 60000.20, true  },   // first tick: seeds the candle
+    {  1, 60000.10, 60000.30, false },   // low 60000.10, mid +0.10
+    {  2, 60050.00, 60050.20, true  },
+    {  3, 60040.00, 60040.20, false },   // inside the candle
+    {  4, 60099.50, 60099.70, true  },   // range 99.60: not golden yet
+    {  5, 60100.00, 60100.20, false },   // high 60100.20, mid +0.50
+    {  6, 60099.90, 60100.10, false },   // inside; close 60100.10
+    { 60, 60095.00, 60095.20, true  },   // next minute: plan
+};
+
+int32_t make(bool conflate){
+    const int32_t h = EA_CreateContext();
+    EA_Init(h, "BTCUSD", 1, 2, 0.01);
+    EA_SetFlag(h, "conflate", conflate ? 1 : 0);
+    EA_SetParamDouble(h, "conflate_points", 100.0);
+    return h;
+}
+
+double sar_of(int32_t h){
+    double sar = 0; int32_t dir = 0;
+    EA_GetTfSar(h, EA_TF_M1, &sar, &dir);
+    return sar;
+}
+
+void candle_exact(){
+    const int64_t t = 1700000040;
+    const int32_t hs[2] = { make(false), make(true) };
+    double entry[2] = {}, sl[2] = {};
+    for(int32_t k=0;k<2;++k){
+        int32_t planned = 0;
+        for(const Tick& tk : kCandle){
+            int32_t a = 0;
+            EA_OnTick(hs[k], tk.bid, tk.ask, t+tk.dt, 0, &a);
+            planned += a==EA_PLAN_ORDERS;
+        }
+        CHECK(planned==1);
+        double tp, lots; int32_t q;
+        CHECK(EA_PlanOrderGet(hs[k], 0, &entry[k], &sl[k], &tp, &lots, &q)==1);
+    }
+    // Same plan off the same close (ask 60100.10 + 35.00)
+    CHECK(std::fabs(entry[0]-60135.10)<1e-9 && entry[1]==entry[0] && sl[1]==sl[0]);
+
+    // The bid bars see every tick either way
+    EA_Bar b0[2], b1[2];
+    CHECK(EA_GetBars(hs[0], EA_TF_M1, 0, 2, b0)==2 && EA_GetBars(hs[1], EA_TF_M1, 0, 2, b1)==2);
+    for(int32_t i=0;i<2;++i)
+        CHECK(b0[i].time==b1[i].time && b0[i].open==b1[i].open && b0[i].high==b1[i].high &&
+              b0[i].low==b1[i].low && b0[i].close==b1[i].close && b0[i].ticks==b1[i].ticks);
+    CHECK(std::fabs(b1[1].high-60100.00)<1e-9 && std::fabs(b1[1].low-60000.00)<1e-9 && b1[1].ticks==7);
+
+    int64_t full = -1, conflated = -1;
+    EA_TickCounters(hs[0], &full, &conflated);
+    CHECK(full==8 && conflated==0);
+    int64_t want_full = 0;
+    for(const Tick& tk : kCandle) want_full += tk.full;
+    EA_TickCounters(hs[1], &full, &conflated);
+    CHECK(full==want_full && conflated==8-want_full);
+
+    for(int32_t h : hs) EA_DestroyContext(h);
+}
+
+// SAR catch-up. Each full-path tick steps the SAR with the extremes of the
+// ticks skipped since the last one: a skipped dip pulls the SAR down to it,
+// and a skipped high becomes the extreme point the next step moves towards.
+void sar_catch_up(){
+    const int64_t t = 1700003000;
+    const int32_t h = make(true);
+    int32_t a = 0;
+    EA_OnTick(h, 60000.00, 60000.20, t,   0, &a);   // full: SAR 60000.00, EP 60000.20
+    EA_OnTick(h, 59999.50, 59999.70, t+1, 0, &a);   // skipped dip (mid -0.50)
+    CHECK(std::fabs(sar_of(h)-60000.00)<1e-9);
+    EA_OnTick(h, 60001.50, 60001.70, t+2, 0, &a);   // full: clamped to the skipped low
+    CHECK(std::fabs(sar_of(h)-59999.50)<1e-9);
+    EA_OnTick(h, 60002.00, 60002.20, t+3, 0, &a);   // skipped high (mid +0.50)
+    EA_OnTick(h, 59999.00, 59999.20, t+4, 0, &a);   // full: EP 60002.20, SAR clamped to 59999.00
+    CHECK(std::fabs(sar_of(h)-59999.00)<1e-9);
+    EA_OnTick(h, 60004.00, 60004.20, t+5, 0, &a);   // full: 59999.00 + 0.003*(60002.20-59999.00)
+    CHECK(std::fabs(sar_of(h)-59999.0096)<1e-7);    // 59999.0054 had the skipped high been lost
+    int64_t full = -1, conflated = -1;
+    EA_TickCounters(h, &full, &conflated);
+    CHECK(full==4 && conflated==2);
+    EA_DestroyContext(h);
+}
+
+}
+
+int main(){
+    candle_exact();
+    sar_catch_up();
+    if(g_fail) return 1;
+    std::printf("conflation: ok\n");
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Execution quality: order callbacks are matched to the plan's legs and
+// aggregated per (level, qualification code).
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "ea_api.h"
+#include "test_util.h"
+
+namespace {
+
+// The golden candle's plan; returns its leg count.
+int32_t golden_plan(int32_t h){
+    return golden_candle(h, 1700000040) ? EA_PlanOrdersCount(h) : 0;
+}
+
+const EA_ExecStats* row(const std::vector<EA_ExecStats>& v, int32_t n, int32_t level, int32_t qual){
+    for(int32_t i=0;i<n;++i) if(v[i].level==level && v[i].qualification_code==qual) return &v[i];
+    return nullptr;
+}
+
+void legs_and_timing(){
+    const int32_t h = EA_CreateContext();
+    EA_Init(h, "BTCUSD", 1, 2, 0.01);
+    EA_ApplyLevel(h, 11);
+    CHECK(golden_plan(h)==3);
+    double entry[3] = {}; int32_t qual[3] = {};
+    for(int32_t i=0;i<3;++i){
+        double sl, tp, lots;
+        EA_PlanOrderGet(h, i, &entry[i], &sl, &tp, &lots, &qual[i]);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    EA_OnOrderPlaced(h, 9, 4242);           // not a leg of the plan
+    EA_OnOrderPlaced(h, 11, qual[0]);
+    EA_OnOrderPlaced(h, 12, qual[1]);
+    EA_OnOrderPlaced(h, 13, qual[2]);
+    EA_OnOrderPlaced(h, 14, qual[2]);       // leg already placed
+    std::this_thread::sleep_for(std::chrono::milliseconds(3));
+    EA_OnOrderFilled(h, 11, entry[0] + 0.50);   // 50 points worse
+    EA_OnOrderFilled(h, 12, entry[1] - 0.10);   // 10 points better
+    EA_OnOrderFilled(h, 99, entry[0]);          // unknown ticket
+    EA_OnOrderClosed(h, 13, 0, 0);              // cancelled while pending
+    EA_OnOrderFilled(h, 13, entry[2]);
+
+    std::vector<EA_ExecStats> v(8);
+    CHECK(EA_GetExecStats(h, nullptr, 0)==3);
+    const int32_t n = EA_GetExecStats(h, v.data(), (int32_t)v.size());
+    CHECK(n==3);
+    const EA_ExecStats* a = row(v, n, 11, LEVEL_11_FIRST);
+    const EA_ExecStats* b = row(v, n, 11, LEVEL_11_SECOND);
+    const EA_ExecStats* c = row(v, n, 11, LEVEL_11_THIRD);
+    CHECK(a && b && c);
+    if(a && b && c){
+        CHECK(a->slippage_points.count==1 && a->slippage_points.mean==50.0 && a->slippage_points.worst==50.0);
+        CHECK(b->slippage_points.count==1 && b->slippage_points.p50==-10.0);
+        CHECK(c->place_delay_ms.count==1 && c->fill_time_ms.count==0 && c->slippage_points.count==0);
+        CHECK(a->place_delay_ms.worst>=3.0 && a->place_delay_ms.worst<1000.0);
+        CHECK(a->fill_time_ms.mean>=3.0 && a->fill_time_ms.p99<1000.0);
+        CHECK(a->place_delay_ms.worst <= c->place_delay_ms.worst);
+    }
+    CHECK(EA_GetExecStats(h, nullptr, 1)==-2);
+    CHECK(EA_GetExecStats(0, v.data(), 1)==-1);
+    EA_DestroyContext(h);
+
+    // A new context in the same slot starts empty
+    const int32_t h2 = EA_CreateContext();
+    CHECK(EA_GetExecStats(h2, v.data(), 1)==0);
+    EA_DestroyContext(h2);
+}
+
+// Many plans on a walk, every leg filled with a known slippage: the signed
+// quantiles match the exact ones (small values have exact buckets).
+void quantiles(){
+    const int32_t h = EA_CreateContext();
+    EA_Init(h, "BTCUSD", 1, 2, 0.01);
+    std::vector<double> slips;
+    Walk w{99, 60000.0};
+    int32_t ticket = 0;
+    for(int32_t i=0;i<200000;++i){
+        const double px = w.step((i/3000)%3==0 ? 400 : 60, 0.01);
+        int32_t a = 0;
+        EA_OnTick(h, px, px+0.2, 1700000040 + i/10, 0, &a);
+        if(a!=EA_PLAN_ORDERS) continue;
+        double e, sl, tp, lots; int32_t q;
+        EA_PlanOrderGet(h, 0, &e, &sl, &tp, &lots, &q);
+        EA_OnOrderPlaced(h, ++ticket, q);
+        const int32_t slip = ticket%21 - 5;
+        EA_OnOrderFilled(h, ticket, e + slip*0.01);
+        slips.push_back(slip);
+        EA_OnOrderClosed(h, ticket, 0, 1);   // stay on level 1
+    }
+    CHECK(slips.size()>=30);
+    std::vector<EA_ExecStats> v(4);
+    CHECK(EA_GetExecStats(h, v.data(), 4)==1);
+    const EA_ExecDist& d = v[0].slippage_points;
+    CHECK(v[0].level==1 && v[0].qualification_code==LEVEL_1_MAIN);
+    CHECK(d.count==(int64_t)slips.size());
+    std::sort(slips.begin(), slips.end());
+    double sum = 0; for(double x : slips) sum += x;
+    CHECK(std::fabs(d.mean - sum/slips.size()) < 1e-9);
+    CHECK(d.worst==slips.back());
+    const double q[3] = { 0.5, 0.9, 0.99 }, got[3] = { d.p50, d.p90, d.p99 };
+    for(int32_t i=0;i<3;++i){
+        size_t r = (size_t)(q[i]*slips.size() + 0.5); if(r<1) r = 1;
+        CHECK(got[i]==slips[r-1]);
+    }
+    std::printf("  %zu fills, slippage p50 %.0f p90 %.0f p99 %.0f\n", slips.size(), d.p50, d.p90, d.p99);
+    EA_DestroyContext(h);
+}
+
+}
+
+int main(){
+    legs_and_timing();
+    quantiles();
+    if(g_fail) return 1;
+    std::printf("execution: ok\n");
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Drives two contexts, then checks the Prometheus page both through
+// EA_MetricsRender and over the loopback socket served by EA_MetricsStart.
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "ea_api.h"
+#include "test_util.h"
+
+namespace {
+
+bool has(const std::string& s, const char* line){ return s.find(line) != std::string::npos; }
+
+// Sized in two calls; latency values may re-format between them, hence the slack.
+std::string render(){
+    int32_t n = EA_MetricsRender(nullptr, 0);
+    std::string s((size_t)n + 256, '\0');
+    n = EA_MetricsRender(&s[0], (int32_t)s.size());
+    CHECK(n > 0 && n < (int32_t)s.size());
+    s.resize((size_t)n);
+    return s;
+}
+
+std::string http_get(int32_t port, const char* path){
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in a; std::memset(&a, 0, sizeof(a));
+    a.sin_family = AF_INET; a.sin_port = htons((uint16_t)port);
+    a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    std::string out;
+    if(connect(fd, (sockaddr*)&a, sizeof(a))==0){
+        std::string req = std::string("GET ") + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+        send(fd, req.data(), req.size(), 0);
+        char buf[4096]; ssize_t k;
+        while((k = recv(fd, buf, sizeof(buf), 0)) > 0) out.append(buf, (size_t)k);
+    }
+    close(fd);
+    return out;
+}
+
+// Wide first candle, then a rising second one: golden candle + MA.
+int32_t drive(int32_t h){
+    double px = 60000.0;
+    int32_t plans = 0;
+    for(int i=0;i<120;++i){
+        int32_t action = 0;
+        px += (i<40) ? ((i%2) ? 80.0 : -60.0) : 5.0;
+        EA_OnTick(h, px, px+0.2, 1700000000 + i*60/40, 0, &action);
+        if(action==EA_PLAN_ORDERS) ++plans;
+    }
+    return plans;
+}
+
+}
+
+int main(){
+    int32_t a = EA_CreateContext(), b = EA_CreateContext();
+    EA_Init(a, "BTCUSD", 1, 2, 0.01);
+    EA_Init(b, "ETHUSD", 2, 2, 0.01);
+    EA_ApplyLevel(b, 7);
+
+    const int32_t plans = drive(a);
+    for(int i=0;i<10;++i){ int32_t action; EA_OnTick(b, 3000.0+i, 3000.2+i, 1700000000+i, 0, &action); }
+    CHECK(EA_OnTick(a, 1, 1, 1, 0, nullptr) == -1);      // invalid argument
+    CHECK(EA_CurrentLevel(0x7fffffff) == -1);            // invalid handle
+
+    std::string m = render();
+    CHECK(has(m, "# TYPE ea_ticks_total counter\n"));
+    CHECK(has(m, "ea_contexts 2\n"));
+    CHECK(has(m, "ea_ticks_total{path=\"full\"} 130\n"));
+    CHECK(has(m, "ea_ticks_total{path=\"conflated\"} 0\n"));
+    CHECK(has(m, (std::string("ea_plans_total ") + std::to_string(plans) + "\n").c_str()));
+    CHECK(plans >= 1);
+    CHECK(has(m, "ea_signals_total{type=\"golden_candle\"} "));
+    CHECK(!has(m, "ea_signals_total{type=\"golden_candle\"} 0\n"));
+    CHECK(has(m, "ea_contexts_by_level{level=\"1\"} 1\n"));
+    CHECK(has(m, "ea_contexts_by_level{level=\"7\"} 1\n"));
+    CHECK(has(m, "ea_errors_total{kind=\"invalid_argument\"} 1\n"));
+    CHECK(!has(m, "ea_errors_total{kind=\"invalid_handle\"} 0\n"));
+    EA_Stats st; EA_GetStats(a, &st);
+    if(st.enabled){
+        CHECK(has(m, "ea_call_latency_seconds{fn=\"on_tick\",quantile=\"0.99\"} "));
+        CHECK(has(m, "ea_call_latency_seconds_count{fn=\"on_tick\"} 130\n"));
+    }
+
+    // Funnel: every evaluated candle stops at one gate; all in 22:00 UTC
+    EA_Funnel f;
+    CHECK(EA_GetFunnel(a, &f)==1);
+    const int64_t* g = f.total;
+    CHECK(g[EA_FUNNEL_PLANNED]==plans && g[EA_FUNNEL_CANDLES]>=2);
+    CHECK(g[EA_FUNNEL_CANDLES]==g[EA_FUNNEL_NOT_GOLDEN] + g[EA_FUNNEL_NO_TRIGGER] + g[EA_FUNNEL_HTF_VETO]
+                                + g[EA_FUNNEL_RISK_VETO] + g[EA_FUNNEL_PLANNED]);
+    CHECK(g[EA_FUNNEL_SAR_UP] + g[EA_FUNNEL_MA_UP] >= g[EA_FUNNEL_PLANNED]);
+    CHECK(f.by_hour[22][EA_FUNNEL_CANDLES]==g[EA_FUNNEL_CANDLES] && f.by_hour[21][EA_FUNNEL_CANDLES]==0);
+    CHECK(has(m, (std::string("ea_funnel_total{gate=\"planned\"} ") + std::to_string(plans) + "\n").c_str()));
+    EA_SetFlag(b, "paused", 1);
+    for(int i=0;i<3;++i){ int32_t action; EA_OnTick(b, 3000.0, 3000.2, 1700000000 + 3600 + i, 0, &action); }
+    EA_SetFlag(b, "paused", 0);
+    for(int i=0;i<2;++i){ int32_t action; EA_OnTick(b, 3000.0, 3000.2, 1700000000 + 3600 + i, 1, &action); }
+    CHECK(EA_GetFunnel(b, &f)==1);
+    CHECK(f.by_hour[23][EA_FUNNEL_PAUSED]==3 && f.by_hour[23][EA_FUNNEL_IN_POSITION]==2);
+    CHECK(f.total[EA_FUNNEL_PAUSED]==3 && f.total[EA_FUNNEL_PLANNED]==0);
+    // The same ticks under the kill switch stop at the risk gate
+    const int32_t k = EA_CreateContext();
+    EA_Init(k, "XAUUSD", 3, 2, 0.01);
+    EA_KillSwitch(1);
+    CHECK(drive(k)==0);
+    EA_KillSwitch(0);
+    CHECK(EA_GetFunnel(k, &f)==1 && f.total[EA_FUNNEL_RISK_VETO]==plans && f.total[EA_FUNNEL_PLANNED]==0);
+    CHECK(EA_GetFunnel(k, nullptr)==-2);
+    EA_DestroyContext(k);
+
+    // Truncation keeps the NUL and reports the full size.
+    char small[16];
+    CHECK(EA_MetricsRender(small, sizeof(small)) > (int32_t)sizeof(small));
+    CHECK(std::strlen(small) == sizeof(small)-1);
+
+    int32_t port = EA_MetricsStart(0);
+    if(port < 0){ std::printf("metrics server compiled out, skipping socket checks\n"); }
+    else {
+        CHECK(EA_MetricsStart(0) == port);               // already running
+        std::string r = http_get(port, "/metrics");
+        CHECK(r.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+        CHECK(has(r, "Content-Type: text/plain; version=0.0.4"));
+        CHECK(has(r, "ea_ticks_total{path=\"full\"} 130\n"));
+        CHECK(http_get(port, "/nope").rfind("HTTP/1.1 404", 0) == 0);
+        EA_MetricsStop();
+        CHECK(http_get(port, "/metrics").empty());
+        CHECK(EA_MetricsStart(0) > 0);                   // restartable
+        EA_MetricsStop();
+    }
+
+    // EA_ResetStats is applied by the context's next timed call
+    if(st.enabled){
+        EA_ResetStats(a);
+        EA_GetStats(a, &st);
+        CHECK(st.fn[EA_FN_ONTICK].calls>1);   // not applied yet
+        int32_t action;
+        EA_OnTick(a, 60000.0, 60000.2, 1700090000, 0, &action);
+        EA_GetStats(a, &st);
+        CHECK(st.fn[EA_FN_ONTICK].calls==1 && st.fn[EA_FN_INIT].calls==0);
+    }
+
+    EA_DestroyContext(a); EA_DestroyContext(b);
+    if(g_fail){ std::printf("%d check(s) failed\n%s", g_fail, m.c_str()); return 1; }
+    std::printf("metrics ok (%zu bytes)\n", m.size());
+    return 0;
+}
@@ -0,0 +1,33 @@
+// Fills the whole context pool: every slot, the last one included, must hand
+// out a handle that reaches that slot and no other; stale handles stay dead
+// once the slots are recycled.
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include "ea_api.h"
+#include "test_util.h"
+
+int main(){
+    std::vector<int32_t> hs;
+    for(int32_t h; (h = EA_CreateContext()) > 0; ) hs.push_back(h);
+    CHECK(hs.size()==8192);
+    for(size_t i=0;i<hs.size();++i) EA_ApplyLevel(hs[i], 1 + (int32_t)(i % 25));
+    int32_t wrong = 0;
+    for(size_t i=0;i<hs.size();++i) wrong += EA_CurrentLevel(hs[i]) != 1 + (int32_t)(i % 25);
+    CHECK(wrong==0);
+
+    for(int32_t h : hs) EA_DestroyContext(h);
+    int32_t stale = 0;
+    for(int32_t h : hs) stale += EA_CurrentLevel(h) != -1;
+    CHECK(stale==0);
+    std::vector<int32_t> again;
+    for(int32_t h; (h = EA_CreateContext()) > 0; ) again.push_back(h);
+    CHECK(again.size()==hs.size());
+    for(int32_t h : hs) stale += EA_CurrentLevel(h) != -1;
+    for(int32_t h : again) stale += EA_CurrentLevel(h) != 1;
+    CHECK(stale==0);
+    for(int32_t h : again) EA_DestroyContext(h);
+    if(g_fail) return 1;
+    std::printf("pool: ok (%zu slots)\n", hs.size());
+    return 0;
+}
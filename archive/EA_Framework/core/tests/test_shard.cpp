@@ -0,0 +1,212 @@
+// Sharded engine: two producer threads feed 64 symbols (ticks and order
+// events) through 4 workers while two threads poll plans; every context must
+// end up with the same plans and tick counters as a twin driven directly on
+// one thread.
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "ea_api.h"
+#include "test_util.h"
+
+namespace {
+
+const int32_t kSymbols = 64, kRounds = 24;
+
+struct Ev { int32_t kind; double bid, ask; int64_t t; int32_t a, b; };   // kind 0 = tick
+
+// Per round: the golden candle (test_util.h), then the order lifecycle of
+// one leg; closes alternate TP/TP/SL so the level moves both ways.
+std::vector<Ev> stream(int32_t k){
+    std::vector<Ev> ev;
+    int64_t t = 1700000040;
+    for(int32_t j=0;j<kRounds;++j){
+        const double base = 50000.0 + 100.0*k + 7.0*j;
+        for(const GoldenTick& g : kGoldenTicks)
+            ev.push_back({0, base+g.bid, base+g.bid+kGoldenSpread, t+g.dt, 0, 0});
+        const int32_t ticket = 1000*k + j;
+        ev.push_back({EA_SHARD_ORDER_PLACED, 0, 0, 0, ticket, LEVEL_1_MAIN});
+        ev.push_back({EA_SHARD_ORDER_FILLED, base+200.0, 0, 0, ticket, 0});
+        ev.push_back({EA_SHARD_ORDER_CLOSED, 0, 0, 0, ticket, j%3==2 ? 2 : 1});
+        t += 120;
+    }
+    return ev;
+}
+
+int32_t make(int32_t k){
+    char sym[16];
+    std::snprintf(sym, sizeof(sym), "SYM%02d", k);
+    const int32_t h = EA_CreateContext();
+    EA_Init(h, sym, 1, 2, 0.01);
+    return h;
+}
+
+// Start/stop churn under a submitting thread: every tick a submit accepted
+// must have run by the time EA_ShardStop returns, none left for a restart.
+void stop_churn(){
+    const int32_t h = make(99);
+    std::atomic<bool> quit{false};
+    std::atomic<int64_t> accepted{0}, refused{0};
+    std::thread producer([&]{
+        for(int64_t i=0; !quit.load(std::memory_order_relaxed); ++i){
+            if(EA_ShardSubmitTick(h, 60000.0, 60000.2, 1700000040 + i/1000, 0)==1) accepted.fetch_add(1);
+            else refused.fetch_add(1);
+        }
+    });
+    int32_t mismatched = 0;
+    for(int32_t r=0;r<200;++r){
+        EA_ShardStart(2, 0);
+        const int64_t a0 = accepted.load();
+        while(accepted.load()==a0 && r%2) std::this_thread::yield();   // odd rounds: stop mid-stream
+        EA_ShardStop();
+        // Two refusals after the stop: the producer's accepted count is final
+        const int64_t z0 = refused.load();
+        while(refused.load() < z0+2) std::this_thread::yield();
+        int64_t full = 0, conflated = 0;
+        EA_TickCounters(h, &full, &conflated);
+        mismatched += full+conflated != accepted.load();
+    }
+    quit.store(true);
+    producer.join();
+    CHECK(mismatched==0);
+    EA_DestroyContext(h);
+}
+
+bool same(const EA_ShardPlan& a, const EA_ShardPlan& b){
+    if(a.count!=b.count || a.time!=b.time) return false;
+    for(int32_t i=0;i<a.count;++i){
+        const EA_ShardLeg &x = a.legs[i], &y = b.legs[i];
+        if(std::fabs(x.entry-y.entry)>1e-9 || std::fabs(x.sl-y.sl)>1e-9 || std::fabs(x.tp-y.tp)>1e-9 ||
+           x.lots!=y.lots || x.qualification_code!=y.qualification_code) return false;
+    }
+    return true;
+}
+
+}
+
+int main(){
+    std::vector<std::vector<Ev>> ev(kSymbols);
+    for(int32_t k=0;k<kSymbols;++k) ev[k] = stream(k);
+
+    // Reference: direct calls, one thread
+    std::vector<int32_t> ref_h(kSymbols);
+    std::vector<std::vector<EA_ShardPlan>> ref(kSymbols);
+    for(int32_t k=0;k<kSymbols;++k){
+        const int32_t h = ref_h[k] = make(k);
+        for(const Ev& e : ev[k]){
+            switch(e.kind){
+            case 0: {
+                int32_t action = 0;
+                EA_OnTick(h, e.bid, e.ask, e.t, 0, &action);
+                if(action!=EA_PLAN_ORDERS) break;
+                EA_ShardPlan p{};
+                p.handle = h; p.count = EA_PlanOrdersCount(h); p.time = e.t;
+                for(int32_t i=0;i<p.count;++i){
+                    int32_t q = 0;
+                    EA_ShardLeg& l = p.legs[i];
+                    EA_PlanOrderGet(h, i, &l.entry, &l.sl, &l.tp, &l.lots, &q);
+                    l.qualification_code = q;
+                }
+                ref[k].push_back(p);
+                break;
+            }
+            case EA_SHARD_ORDER_PLACED: EA_OnOrderPlaced(h, e.a, e.b); break;
+            case EA_SHARD_ORDER_FILLED: EA_OnOrderFilled(h, e.a, e.bid); break;
+            case EA_SHARD_ORDER_CLOSED: EA_OnOrderClosed(h, e.a, e.b & 1, (e.b>>1) & 1); break;
+            }
+        }
+    }
+    CHECK(ref[0].size()==(size_t)kRounds);
+
+    // Sharded: producer p owns the symbols k%2==p and interleaves their streams
+    std::vector<int32_t> hs(kSymbols);
+    for(int32_t k=0;k<kSymbols;++k) hs[k] = make(k);
+    CHECK(EA_ShardSubmitTick(hs[0], 1.0, 1.1, 1, 0)==0);   // not running
+    CHECK(EA_ShardOf(hs[0])==-1);
+    const int32_t workers = EA_ShardStart(4, 0);
+    if(workers<0){
+        std::printf("shard engine compiled out, skipping\n");
+        return g_fail ? 1 : 0;
+    }
+    CHECK(workers==4);
+    CHECK(EA_ShardStart(8, 0)==4);
+    std::vector<int32_t> per_shard(4);
+    for(int32_t k=0;k<kSymbols;++k){
+        const int32_t s = EA_ShardOf(hs[k]);
+        CHECK(s>=0 && s<4);
+        if(s>=0 && s<4) ++per_shard[s];
+    }
+    for(int32_t n : per_shard) CHECK(n>0);
+    CHECK(EA_ShardSubmitTick(-7, 1.0, 1.1, 1, 0)==-1);
+    CHECK(EA_ShardSubmitOrder(hs[0], 9, 1, 0, 0.0)==-2);
+
+    std::atomic<int64_t> retries{0};
+    auto producer = [&](int32_t p){
+        const size_t n = ev[0].size();
+        for(size_t i=0;i<n;++i)
+            for(int32_t k=p;k<kSymbols;k+=2){
+                const Ev& e = ev[k][i];
+                for(;;){
+                    const int32_t rc = e.kind==0 ? EA_ShardSubmitTick(hs[k], e.bid, e.ask, e.t, 0)
+                                                 : EA_ShardSubmitOrder(hs[k], e.kind, e.a, e.b, e.bid);
+                    if(rc==1) break;
+                    retries.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                }
+            }
+    };
+    std::vector<std::vector<EA_ShardPlan>> got(kSymbols), got2(kSymbols);
+    auto slot = [&](int32_t h){ for(int32_t k=0;k<kSymbols;++k) if(hs[k]==h) return k; return -1; };
+    auto drain = [&](std::vector<std::vector<EA_ShardPlan>>& into){
+        EA_ShardPlan p;
+        int32_t n = 0;
+        while(EA_ShardPollPlan(&p)==1){
+            const int32_t k = slot(p.handle);
+            CHECK(k>=0);
+            if(k>=0) into[k].push_back(p);
+            ++n;
+        }
+        return n;
+    };
+    std::thread p0(producer, 0), p1(producer, 1);
+    std::atomic<bool> done{false};
+    int32_t live = 0, live2 = 0;
+    std::thread joiner([&]{ p0.join(); p1.join(); done.store(true); });
+    // A second poller: overlapping polls must neither lose nor repeat a plan
+    std::thread poller([&]{ while(!done.load()){ live2 += drain(got2); std::this_thread::yield(); } });
+    while(!done.load()){ live += drain(got); std::this_thread::yield(); }
+    joiner.join();
+    poller.join();
+    EA_ShardStop();
+    drain(got);
+    live += live2;
+    // Each poller sees a context's plans in emission order; merge by tick time
+    for(int32_t k=0;k<kSymbols;++k){
+        got[k].insert(got[k].end(), got2[k].begin(), got2[k].end());
+        std::sort(got[k].begin(), got[k].end(), [](const EA_ShardPlan& a, const EA_ShardPlan& b){ return a.time<b.time; });
+    }
+    CHECK(EA_ShardSubmitTick(hs[0], 1.0, 1.1, 1, 0)==0);   // stopped again
+    CHECK(EA_ShardPollPlan(nullptr)==0);
+
+    for(int32_t k=0;k<kSymbols;++k){
+        CHECK(got[k].size()==ref[k].size());
+        bool match = got[k].size()==ref[k].size();
+        for(size_t i=0; match && i<ref[k].size(); ++i) match = same(got[k][i], ref[k][i]);
+        CHECK(match);
+        int64_t f0=0, c0=0, f1=0, c1=0;
+        EA_TickCounters(ref_h[k], &f0, &c0);
+        EA_TickCounters(hs[k], &f1, &c1);
+        CHECK(f0==f1 && c0==c1);
+        CHECK(EA_CurrentLevel(ref_h[k])==EA_CurrentLevel(hs[k]));
+    }
+
+    for(int32_t k=0;k<kSymbols;++k){ EA_DestroyContext(ref_h[k]); EA_DestroyContext(hs[k]); }
+    stop_churn();
+    if(g_fail) return 1;
+    std::printf("shard: ok (%d plans, %d polled live, %lld retries)\n",
+                (int)(kSymbols*ref[0].size()), live, (long long)retries.load());
+    return 0;
+}
@@ -0,0 +1,29 @@
+// Research build (ea_core_bodywick, EA_CORE_STRATEGY=ea::BodyWickStrategy):
+// the body/wick golden candle still takes the spec candle but refuses one
+// the default range check accepts.
+#include <cstdio>
+#include <cstdint>
+#include "ea_api.h"
+#include "test_util.h"
+
+namespace {
+
+// The golden candle with the close at base+close_off (bid).
+bool candle(double close_off){
+    const int32_t h = EA_CreateContext();
+    EA_Init(h, "BTCUSD", 1, 2, 0.01);
+    const bool planned = golden_candle(h, 1700000040, 60000.0, close_off);
+    EA_DestroyContext(h);
+    return planned;
+}
+
+}
+
+int main(){
+    CHECK(candle(190.0));    // body 190, wicks 10.2: ratio ~18.6
+    CHECK(!candle(100.0));   // body 100, upper wick 100: ratio 1 < 2
+    CHECK(!candle(-10.0));   // bearish close
+    if(g_fail) return 1;
+    std::printf("strategy: ok\n");
+    return 0;
+}
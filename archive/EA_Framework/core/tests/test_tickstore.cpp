@@ -0,0 +1,262 @@
+// Columnar tick store round trip (tools/tickstore.h), raw and packed, the
+// threaded chunk stream, time-range seeks and splits through the directory,
+// and EA_OnTicks over its spans against the same ticks through EA_OnTick.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "ea_api.h"
+#include "test_util.h"
+#include "tickstore.h"
+
+namespace {
+
+using namespace ea::tools;
+
+void round_trip(const TickColumns& ticks){
+    const int64_t n = (int64_t)ticks.time.size(), chunk = 10007;
+    StoreWriter w;
+    CHECK(w.open("tickstore.ticks", "BTCUSD", 2, 0.01, chunk));
+    for(int64_t i=0;i<n;++i) w.push(ticks.time[i], ticks.bid[i], ticks.ask[i]);
+    CHECK(w.close());
+
+    StoreReader r;
+    CHECK(r.open("tickstore.ticks"));
+    const StoreHeader& h = r.header();
+    CHECK(std::strcmp(h.symbol, "BTCUSD")==0 && h.digits==2 && h.point==0.01);
+    CHECK(h.ticks==n && h.chunks==(n + chunk-1)/chunk && h.chunk_ticks==chunk);
+    CHECK(h.min_time==ticks.time.front() && h.max_time==ticks.time.back());
+    int64_t k = 0, bad = 0;
+    for(int64_t c=0;c<r.chunks();++c){
+        const TickSpan s = r.chunk(c);
+        const StoreChunk& info = r.chunk_info(c);
+        CHECK(s.n==(c+1<r.chunks() ? chunk : n - c*chunk));
+        CHECK(info.min_time==s.time[0] && info.max_time==s.time[s.n-1]);
+        CHECK((uintptr_t)s.time % kStoreAlign==0 && (uintptr_t)s.bid % kStoreAlign==0 && (uintptr_t)s.ask % kStoreAlign==0);
+        for(int64_t i=0;i<s.n;++i,++k)
+            bad += s.time[i]!=ticks.time[k] || s.bid[i]!=ticks.bid[k] || s.ask[i]!=ticks.ask[k];
+    }
+    CHECK(k==n && bad==0);
+    r.close();
+
+    // A truncated file is refused, as is a CSV
+    FILE* f = std::fopen("tickstore.ticks", "r+b");
+    std::fseek(f, 0, SEEK_END);
+    const long size = std::ftell(f);
+    std::fclose(f);
+    CHECK(::truncate("tickstore.ticks", size - 8)==0);
+    CHECK(is_store("tickstore.ticks") && !r.open("tickstore.ticks"));
+    f = std::fopen("tickstore.csv", "w");
+    std::fprintf(f, "1700000000,60000.00,60000.20\n");
+    std::fclose(f);
+    CHECK(!is_store("tickstore.csv") && !r.open("tickstore.csv"));
+
+    // No ticks: a valid store with no chunks
+    CHECK(w.open("tickstore.ticks", "", 5, 0.00001) && w.close());
+    CHECK(r.open("tickstore.ticks") && r.chunks()==0 && r.header().ticks==0);
+}
+
+// Ranges opened through the directory match a scan of the columns; a split
+// covers the range with cuts on chunk boundaries.
+void seek_and_split(const TickColumns& ticks, int32_t codec){
+    const int64_t chunk = 4096;
+    StoreWriter w;
+    CHECK(w.open("tickstore_index.ticks", "BTCUSD", 2, 0.01, chunk, codec));
+    for(size_t i=0;i<ticks.time.size();++i) w.push(ticks.time[i], ticks.bid[i], ticks.ask[i]);
+    CHECK(w.close());
+    StoreReader r;
+    CHECK(r.open("tickstore_index.ticks"));
+    const int64_t t0 = ticks.time.front(), t1 = ticks.time.back();
+    const int64_t probes[][2] = { { t0-100, t1+100 }, { t0, t0 }, { t0+1, t0+2 }, { t0+102, t0+103 },
+                                  { t0+1234, t1-77 }, { t1, t1+1 }, { t1+1, t1+50 }, { t0+500, t0+400 } };
+    for(const auto& p : probes){
+        const TickRange a = r.range(p[0], p[1]), b = time_range(ticks, p[0], p[1]);
+        CHECK(a.begin==b.begin && a.end==b.end);
+        int64_t n = 0, bad = 0;
+        CHECK(r.for_each(a, [&](const TickSpan& s){
+            for(int64_t i=0;i<s.n;++i,++n) bad += s.time[i]!=ticks.time[a.begin+n] || s.bid[i]!=ticks.bid[a.begin+n];
+        }));
+        CHECK(n==a.end-a.begin && bad==0);
+    }
+    CHECK(time_range(ticks, t0, t0+1).end==40);   // 40 ticks a second
+
+    const TickRange all = r.range(t0+3, t1-3);
+    for(int32_t parts : { 1, 3, 7, 64, 1000 }){
+        const std::vector<TickRange> v = r.split(all, parts);
+        CHECK(!v.empty() && (int32_t)v.size()<=parts);
+        CHECK(v.front().begin==all.begin && v.back().end==all.end);
+        for(size_t i=0;i<v.size();++i){
+            CHECK(v[i].end > v[i].begin);
+            if(i) CHECK(v[i].begin==v[i-1].end && v[i].begin % chunk==0);
+        }
+    }
+    CHECK(r.split(r.range(t0+10, t0+11), 4).size()==1);
+    CHECK(r.split(r.range(t1+1, t1+2), 4).empty());
+}
+
+// Packed chunks: on-grid prices (as parsed from an export) come back bit for
+// bit in a fifth of the space or less, off-grid ones rounded to the point;
+// the threaded stream hands out the same spans as a plain walk.
+void packed(const TickColumns& grid, const TickColumns& walk){
+    const int64_t n = (int64_t)grid.time.size(), chunk = 10007;
+    StoreWriter w;
+    CHECK(w.open("tickstore_packed.ticks", "BTCUSD", 2, 0.01, chunk, kStorePacked));
+    for(int64_t i=0;i<n;++i) w.push(grid.time[i], grid.bid[i], grid.ask[i]);
+    CHECK(w.close() && w.requantized()==0);
+    CHECK(w.bytes()*5 <= n*24);
+    std::printf("  packed %.2f bytes/tick\n", (double)w.bytes()/(double)n);
+
+    StoreReader r;
+    CHECK(r.open("tickstore_packed.ticks") && r.packed() && r.header().ticks==n);
+    int64_t k = 0, bad = 0;
+    CHECK(r.for_each(r.all(), [&](const TickSpan& s){
+        for(int64_t i=0;i<s.n;++i,++k) bad += s.time[i]!=grid.time[k] || s.bid[i]!=grid.bid[k] || s.ask[i]!=grid.ask[k];
+    }));
+    CHECK(k==n && bad==0);
+
+    const TickRange part = { 12345, n - 4321 };
+    for(int32_t threads : { 0, 1, 3 }) for(int32_t depth : { 0, 1, 5 }){
+        ChunkStream cs(r, part, threads, depth);
+        TickSpan s;
+        int64_t m = part.begin, spans = 0;
+        bad = 0;
+        while(cs.next(s)){
+            ++spans;
+            for(int64_t i=0;i<s.n;++i,++m) bad += s.time[i]!=grid.time[m] || s.bid[i]!=grid.bid[m] || s.ask[i]!=grid.ask[m];
+        }
+        CHECK(!cs.failed() && m==part.end && bad==0 && spans==(part.end-1)/chunk - part.begin/chunk + 1);
+    }
+    { ChunkStream early(r, r.all(), 2, 2); TickSpan s; CHECK(early.next(s)); }   // left unfinished
+
+    // A chunk whose time stream is cut short fails when reached
+    const int64_t at = r.chunk_info(2).offset;
+    r.close();
+    FILE* f = std::fopen("tickstore_packed.ticks", "r+b");
+    uint32_t tb = 0;
+    std::fseek(f, at, SEEK_SET);
+    CHECK(std::fread(&tb, 4, 1, f)==1);
+    --tb;
+    std::fseek(f, at, SEEK_SET);
+    std::fwrite(&tb, 4, 1, f);
+    std::fclose(f);
+    CHECK(r.open("tickstore_packed.ticks"));
+    {
+        ChunkStream cs(r, r.all(), 1);
+        TickSpan s;
+        int64_t spans = 0;
+        while(cs.next(s)) ++spans;
+        CHECK(cs.failed() && spans==2);
+    }
+    r.close();
+
+    CHECK(w.open("tickstore_packed.ticks", "BTCUSD", 2, 0.01, chunk, kStorePacked));
+    for(size_t i=0;i<walk.time.size();++i) w.push(walk.time[i], walk.bid[i], walk.ask[i]);
+    CHECK(w.close() && w.requantized()>0);
+    CHECK(r.open("tickstore_packed.ticks"));
+    const PriceScale sc(2, 0.01);
+    k = 0; bad = 0;
+    CHECK(r.for_each(r.all(), [&](const TickSpan& s){
+        for(int64_t i=0;i<s.n;++i,++k)
+            bad += s.bid[i]!=sc.price(sc.points(walk.bid[k])) || std::fabs(s.ask[i] - walk.ask[k]) > 0.0051;
+    }));
+    CHECK(k==(int64_t)walk.time.size() && bad==0);
+    r.close();
+
+    // Points must stay below 2^53: larger prices, or digits past what the
+    // scale can hold, are refused instead of packed wrong
+    CHECK(sc.fits(9e13) && !sc.fits(1e14) && !sc.fits(-1e14) && !sc.fits(NAN));
+    CHECK(!w.open("tickstore_packed.ticks", "", 19, 1e-19, chunk, kStorePacked));
+    CHECK(w.open("tickstore_packed.ticks", "BTCUSD", 2, 0.01, chunk, kStorePacked));
+    w.push(1700000000, 60000.0, 60000.2);
+    w.push(1700000001, 60000.0, 1e17);
+    w.push(1700000002, 60000.1, 60000.3);
+    CHECK(!w.close() && w.unpackable()==1);   // the ask
+}
+
+// read_csv across its 64 KiB buffer: every line of a multi-megabyte file in
+// order, CRLF or not, the last one without a '\n'; a line longer than the
+// buffer is dropped whole (its tail would parse on its own).
+void csv_stream(const TickColumns& grid){
+    const size_t n = grid.time.size();
+    FILE* f = std::fopen("tickstore_stream.csv", "wb");
+    std::fprintf(f, "time,bid,ask\r\n");
+    for(size_t i=0;i<n;++i){
+        if(i==n/2) std::fprintf(f, "%s1700000000,1.00,1.10\n", std::string(100000, '0').c_str());
+        std::fprintf(f, "%lld,%.2f,%.2f%s", (long long)grid.time[i], grid.bid[i], grid.ask[i],
+                     i+1==n ? "" : i%2 ? "\r\n" : "\n");
+    }
+    std::fclose(f);
+    TickColumns got;
+    CHECK(load_csv("tickstore_stream.csv", got));
+    CHECK(got.time==grid.time && got.bid==grid.bid && got.ask==grid.ask);
+    CHECK(!load_csv("tickstore_missing.csv", got));
+    std::remove("tickstore_stream.csv");
+}
+
+// The same ticks one by one and in runs: same plans on the same ticks.
+void batch_matches_single(const TickColumns& ticks){
+    const int32_t a = EA_CreateContext(), b = EA_CreateContext();
+    EA_Init(a, "BTCUSD", 1, 2, 0.01);
+    EA_Init(b, "BTCUSD", 1, 2, 0.01);
+    std::vector<int64_t> pa, pb;
+    const int64_t n = (int64_t)ticks.time.size();
+    for(int64_t i=0;i<n;++i){
+        int32_t act = 0;
+        EA_OnTick(a, ticks.bid[i], ticks.ask[i], ticks.time[i], 0, &act);
+        if(act==EA_PLAN_ORDERS) pa.push_back(i);
+    }
+    int64_t k = 0;
+    while(k<n){
+        int32_t act = 0;
+        const int32_t got = EA_OnTicks(b, &ticks.time[k], &ticks.bid[k], &ticks.ask[k], (int32_t)std::min<int64_t>(n-k, 4096), 0, &act);
+        CHECK(got>0);
+        if(got<=0) break;
+        k += got;
+        if(act==EA_PLAN_ORDERS) pb.push_back(k-1);
+    }
+    CHECK(!pa.empty() && pa==pb);
+    CHECK(EA_CurrentLevel(a)==EA_CurrentLevel(b));
+    int64_t fa, ca, fb, cb;
+    EA_TickCounters(a, &fa, &ca);
+    EA_TickCounters(b, &fb, &cb);
+    CHECK(fa==fb && ca==cb);
+
+    // In position the run is never cut short
+    int32_t act = 1;
+    CHECK(EA_OnTicks(b, ticks.time.data(), ticks.bid.data(), ticks.ask.data(), 1000, 1, &act)==1000 && act==EA_NONE);
+    CHECK(EA_OnTicks(b, ticks.time.data(), ticks.bid.data(), ticks.ask.data(), 0, 0, &act)==0);
+    CHECK(EA_OnTicks(b, nullptr, ticks.bid.data(), ticks.ask.data(), 1, 0, &act)==-2);
+    CHECK(EA_OnTicks(b, ticks.time.data(), ticks.bid.data(), ticks.ask.data(), -1, 0, &act)==-2);
+    CHECK(EA_OnTicks(0, ticks.time.data(), ticks.bid.data(), ticks.ask.data(), 1, 0, &act)==-1);
+    std::printf("  %zu plans\n", pa.size());
+    EA_DestroyContext(a);
+    EA_DestroyContext(b);
+}
+
+}
+
+int main(){
+    TickColumns ticks;
+    synth(ticks, 300000);
+    // The walk on the 0.01 grid, as the CSV reader would parse it
+    TickColumns grid;
+    for(size_t i=0;i<ticks.time.size();++i){
+        char line[64];
+        const int len = std::snprintf(line, sizeof(line), "%lld,%.2f,%.2f", (long long)ticks.time[i], ticks.bid[i], ticks.ask[i]);
+        int64_t t; double b, a;
+        if(detail::parse_line(line, line + len, t, b, a)) grid.push(t, b, a);
+    }
+    CHECK(grid.time.size()==ticks.time.size());
+    csv_stream(grid);
+    round_trip(ticks);
+    packed(grid, ticks);
+    seek_and_split(ticks, kStoreRaw);
+    seek_and_split(grid, kStorePacked);
+    batch_matches_single(ticks);
+    if(g_fail) return 1;
+    std::printf("tickstore: ok\n");
+    return 0;
+}
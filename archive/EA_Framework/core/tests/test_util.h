@@ -0,0 +1,17 @@
+// Helpers shared by the test suite and the bench drivers: the CHECK macro,
+// and the synthetic feeds of the host tools (tools/feeds.h).
+#pragma once
+#include <cstdio>
+#include <cstdint>
+#include "ea_api.h"
+#include "feeds.h"
+
+using ea::tools::GoldenTick;
+using ea::tools::kGoldenTicks;
+using ea::tools::kGoldenSpread;
+using ea::tools::golden_candle;
+using ea::tools::signal;
+using ea::tools::Walk;
+
+inline int g_fail = 0;
+#define CHECK(cond) do { if(!(cond)){ std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); ++g_fail; } } while(0)
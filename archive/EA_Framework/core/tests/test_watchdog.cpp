@@ -0,0 +1,109 @@
+// Forces latency budget overruns with tiny budgets and checks the overrun
+// accounting, degraded mode (trace spans shed) and recovery.
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <chrono>
+#include "ea_api.h"
+#include "test_util.h"
+
+namespace {
+void ticks(int32_t h, int n){
+    for(int i=0;i<n;++i){ int32_t a; EA_OnTick(h, 60000.0+i, 60000.2+i, 1700000000, 0, &a); }
+}
+}
+
+int main(){
+    int32_t h = EA_CreateContext();
+    EA_Init(h, "BTCUSD", 1, 2, 0.01);
+    EA_BudgetStatus st;
+    int32_t rc = EA_GetBudgetStatus(h, &st);
+    if(rc==0){ std::printf("watchdog compiled out, skipping\n"); return 0; }
+    CHECK(rc==1);
+    CHECK(st.overruns==0 && st.last_fn==-1 && st.degraded==0);
+
+    // Default budgets (100/500 ms) are never hit by normal calls.
+    ticks(h, 1000);
+    EA_GetBudgetStatus(h, &st);
+    CHECK(st.overruns==0);
+
+    // 1 ns UI budget: every UI call overruns, order-path calls don't. The
+    // setters only publish a snapshot and are not timed.
+    EA_SetParamDouble(h, "budget_ui_ms", 1e-6);
+    EA_CurrentLevel(h);
+    ticks(h, 10);
+    EA_GetBudgetStatus(h, &st);
+    CHECK(st.overruns_by_fn[EA_FN_SET_PARAM]==0);
+    CHECK(st.overruns_by_fn[EA_FN_CURRENT_LEVEL]==1);
+    CHECK(st.overruns_by_fn[EA_FN_ONTICK]==0);
+    CHECK(st.overruns==1);
+    CHECK(st.last_fn==EA_FN_CURRENT_LEVEL && st.last_overrun_ms > 0);
+    CHECK(st.degraded==0);   // degrading is opt-in
+    EA_Stats cs; EA_GetStats(h, &cs);
+    CHECK(cs.fn[EA_FN_SET_PARAM].calls==0);
+
+    // Degraded mode sheds trace spans; overrun events are still recorded.
+    const bool traced = EA_TraceEnable(1) >= 0;      // -1: trace compiled out
+    if(!traced) std::printf("trace compiled out, skipping span checks\n");
+    EA_SetParamDouble(h, "budget_recover_ms", 50);
+    EA_SetFlag(h, "degrade_on_overrun", 1);
+    EA_GetBudgetStatus(h, &st);
+    CHECK(st.degraded==0);                           // not adopted yet
+    EA_CurrentLevel(h);                              // adopts, overruns → degraded
+    EA_GetBudgetStatus(h, &st);
+    CHECK(st.degraded==1 && st.degraded_entries==1);
+    int32_t spans = EA_TraceDump("test_watchdog.json", 0);
+    ticks(h, 100);
+    if(traced) CHECK(EA_TraceDump("test_watchdog.json", 0) == spans);
+    EA_CurrentLevel(h);                              // overrun: one event span
+    if(traced) CHECK(EA_TraceDump("test_watchdog.json", 0) == spans+1);
+    char page[16384];
+    EA_MetricsRender(page, sizeof(page));
+    CHECK(std::string(page).find("ea_degraded_contexts 1\n") != std::string::npos);
+    CHECK(std::string(page).find("ea_call_latency_seconds{") == std::string::npos);
+
+    // Recovery: in-budget calls after budget_recover_ms of quiet leave degraded mode.
+    EA_SetParamDouble(h, "budget_ui_ms", 500);
+    ticks(h, 10);
+    EA_GetBudgetStatus(h, &st);
+    CHECK(st.degraded==1);                           // too early
+    std::this_thread::sleep_for(std::chrono::milliseconds(70));
+    ticks(h, 1);
+    EA_GetBudgetStatus(h, &st);
+    CHECK(st.degraded==0 && st.degraded_entries==1);
+    CHECK(st.degraded_ms >= 50.0);
+    ticks(h, 100);
+    if(traced) CHECK(EA_TraceDump("test_watchdog.json", 0) > spans+1);  // spans flow again
+
+    // Turning degrade_on_overrun off leaves degraded mode at the next call.
+    EA_SetParamDouble(h, "budget_ui_ms", 1e-6);
+    EA_CurrentLevel(h);
+    EA_SetFlag(h, "degrade_on_overrun", 0);
+    EA_GetBudgetStatus(h, &st);
+    CHECK(st.degraded==1 && st.degraded_entries==2);
+    ticks(h, 1);
+    EA_GetBudgetStatus(h, &st);
+    CHECK(st.degraded==0);
+    EA_SetFlag(h, "degrade_on_overrun", 1);
+    EA_SetParamDouble(h, "budget_ui_ms", 500);
+
+    // A degraded context that is destroyed releases its shed.
+    EA_SetParamDouble(h, "budget_order_ms", 1e-6);
+    ticks(h, 1);
+    EA_GetBudgetStatus(h, &st);
+    CHECK(st.degraded==1 && st.degraded_entries==3);
+    EA_DestroyContext(h);
+    int32_t h2 = EA_CreateContext();
+    EA_Init(h2, "BTCUSD", 1, 2, 0.01);
+    spans = EA_TraceDump("test_watchdog.json", 0);
+    ticks(h2, 10);
+    if(traced) CHECK(EA_TraceDump("test_watchdog.json", 0) >= spans+10);   // + the first candle_close
+
+    EA_TraceEnable(0);
+    std::remove("test_watchdog.json");
+    EA_DestroyContext(h2);
+    if(g_fail){ std::printf("%d check(s) failed\n", g_fail); return 1; }
+    std::printf("watchdog ok\n");
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Tick-replay backtest of the core: streams historical ticks through
+// EA_OnTick and plays the broker for the plans it emits, the way
+// GoldenCandleEA.mq4 does live.
+//
+//   backtest <ticks.csv | ticks store | -> [options]
+//
+//   --digits D --point P   symbol scale (default 2 / 0.01, or the store's)
+//   --contract C           account currency per price unit per lot (default 1)
+//   --balance B            starting balance (default 10000)
+//   --config FILE          strategy keys (EA_ConfigLoad)
+//   --level N              starting level (EA_ApplyLevel)
+//   --from T --to T        replay only from <= time < to: epoch seconds,
+//                          "YYYY.MM.DD[ HH:MM:SS]" or "YYYY-MM-DD[ HH:MM:SS]" (UTC)
+//   --expiry S             cancel a BuyStop not filled after S seconds (default 0 = never)
+//   --threads N            decode threads for a packed store (default: spare cores, at most 4)
+//   --synthetic N          ticks of the synthetic walk used with "-" (default 10M)
+//   --trades FILE          one CSV line per closed leg
+//   --equity FILE          balance after each close
+//
+// CSV lines are "time,bid,ask" with epoch seconds or MT4's
+// "YYYY.MM.DD HH:MM:SS[.mmm]"; other lines (headers) are skipped. A tick
+// store (tickstore.h, written by tick_convert) is mapped and replayed chunk by
+// chunk, raw chunks in place and packed ones decoded ahead on --threads; its
+// directory opens a --from/--to range without a scan.
+//
+// Broker model: each planned leg becomes a BuyStop (moved to Ask + 10 points
+// when not above Ask, as the shell does) that never expires unless --expiry
+// is given (then it is cancelled: EA_OnOrderClosed with neither flag). It fills at the
+// first Ask >= entry, at that Ask; an open leg closes at the first Bid <= SL
+// or Bid >= TP, at that Bid, SL first. Fills and exits are applied before
+// the tick reaches EA_OnTick, and hasOpenPosition is set while any leg is
+// pending or open. Every event goes back through EA_OnOrderPlaced / Filled /
+// Closed and EA_ReportClosedProfit, so the level ladder and the account
+// limits run as they would live.
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "ea_api.h"
+#include "feeds.h"
+#include "replay.h"
+#include "tickstore.h"
+
+namespace {
+
+bool arg(int argc, char** argv, int& i, const char* name, const char*& out){
+    if(std::strcmp(argv[i], name)!=0 || i+1>=argc) return false;
+    out = argv[++i];
+    return true;
+}
+
+}
+
+int main(int argc, char** argv){
+    if(argc<2){
+        std::fprintf(stderr, "usage: backtest <ticks.csv|store|-> [--digits D --point P --contract C --balance B "
+                             "--config FILE --level N --from T --to T --expiry S --threads N --synthetic N --trades FILE --equity FILE]\n");
+        return 1;
+    }
+    int32_t digits = 2, level = 1;
+    double point = 0.01, contract = 1.0, balance0 = 10000.0;
+    int64_t synthetic = 10000000, expiry = 0;
+    int64_t from = INT64_MIN, to = INT64_MAX;
+    int32_t threads = (int32_t)std::clamp<unsigned>(std::thread::hardware_concurrency(), 2, 5) - 1;
+    bool scale_set = false, times_ok = true;
+    const char *config = nullptr, *trades_path = nullptr, *equity_path = nullptr;
+    for(int i=2;i<argc;++i){
+        const char* v = nullptr;
+        if(arg(argc, argv, i, "--digits", v))         { digits = std::atoi(v); scale_set = true; }
+        else if(arg(argc, argv, i, "--point", v))     { point = std::atof(v); scale_set = true; }
+        else if(arg(argc, argv, i, "--contract", v))  contract = std::atof(v);
+        else if(arg(argc, argv, i, "--balance", v))   balance0 = std::atof(v);
+        else if(arg(argc, argv, i, "--config", v))    config = v;
+        else if(arg(argc, argv, i, "--level", v))     level = std::atoi(v);
+        else if(arg(argc, argv, i, "--synthetic", v)) synthetic = std::atoll(v);
+        else if(arg(argc, argv, i, "--expiry", v))    expiry = std::atoll(v);
+        else if(arg(argc, argv, i, "--threads", v))   threads = std::max(0, std::atoi(v));
+        else if(arg(argc, argv, i, "--from", v))      times_ok &= ea::tools::parse_time(v, from);
+        else if(arg(argc, argv, i, "--to", v))        times_ok &= ea::tools::parse_time(v, to);
+        else if(arg(argc, argv, i, "--trades", v))    trades_path = v;
+        else if(arg(argc, argv, i, "--equity", v))    equity_path = v;
+        else { std::fprintf(stderr, "unknown option %s\n", argv[i]); return 1; }
+    }
+    if(!times_ok){ std::fprintf(stderr, "bad --from/--to time\n"); return 1; }
+
+    ea::tools::TickColumns ticks;
+    ea::tools::StoreReader store;
+    bool store_open = false;
+    const auto l0 = std::chrono::steady_clock::now();
+    if(std::strcmp(argv[1], "-")==0) ea::tools::synth(ticks, synthetic);
+    else if(ea::tools::is_store(argv[1])){
+        if(!(store_open = store.open(argv[1]))){ std::fprintf(stderr, "bad tick store %s\n", argv[1]); return 1; }
+        if(!scale_set){ digits = store.header().digits; point = store.header().point; }
+    }
+    else if(!ea::tools::load_csv(argv[1], ticks)){ std::fprintf(stderr, "cannot read %s\n", argv[1]); return 1; }
+    const ea::tools::TickRange range = store_open ? store.range(from, to) : ea::tools::time_range(ticks, from, to);
+    const double load_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - l0).count();
+    const int64_t n = range.end - range.begin;
+    if(n==0){ std::fprintf(stderr, "no ticks\n"); return 1; }
+
+    const int32_t h = EA_CreateContext();
+    if(h<=0 || EA_Init(h, "BACKTEST", 1, digits, point)!=1){ std::fprintf(stderr, "init failed\n"); return 1; }
+    if(config && EA_ConfigLoad(h, config)!=1){ std::fprintf(stderr, "%s\n", EA_LastError(h)); return 1; }
+    EA_ApplyLevel(h, level);
+
+    FILE* trades = trades_path ? std::fopen(trades_path, "w") : nullptr;
+    FILE* equity = equity_path ? std::fopen(equity_path, "w") : nullptr;
+    if((trades_path && !trades) || (equity_path && !equity)){ std::fprintf(stderr, "cannot write output\n"); return 1; }
+    if(trades) std::fprintf(trades, "ticket,qual,level,fill_time,fill,close_time,close,exit,profit\n");
+    if(equity) std::fprintf(equity, "time,balance\n");
+
+    ea::tools::Replay rp(h, digits, point, contract, expiry, trades, equity);
+    rp.r.balance = rp.r.peak = rp.r.start = balance0;
+    rp.book.reserve(8);
+
+    const auto w0 = std::chrono::steady_clock::now();
+    bool replay_ok = true;
+    if(store_open){
+        ea::tools::ChunkStream stream(store, range, threads);
+        ea::tools::TickSpan s;
+        while(stream.next(s)) if(!(replay_ok = rp.run(s))) break;
+        if(stream.failed()){ std::fprintf(stderr, "corrupt chunk in %s\n", argv[1]); return 1; }
+    }
+    else replay_ok = rp.run(ea::tools::span_of(ticks, range));
+    if(!replay_ok){ std::fprintf(stderr, "core error during the replay\n"); return 1; }
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - w0).count();
+
+    int64_t pending = 0, open = 0;
+    for(const ea::tools::Leg& g : rp.book) (g.fill==0 ? pending : open) += 1;
+    const ea::tools::Report& r = rp.r;
+    const int64_t closed = r.wins + r.losses;
+    std::printf("ticks        %lld  (load %.2f s, replay %.2f s, %.1f M ticks/s)\n",
+                (long long)n, load_s, wall, (double)n/wall*1e-6);
+    std::printf("plans        %lld  legs placed %lld  expired %lld  filled %lld  closed %lld (tp %lld, sl %lld)  left pending %lld, open %lld\n",
+                (long long)r.plans, (long long)r.placed, (long long)r.expired, (long long)r.filled, (long long)closed,
+                (long long)r.tp, (long long)r.sl, (long long)pending, (long long)open);
+    std::printf("win rate     %.1f%%  profit factor %.2f\n",
+                closed ? 100.0*(double)r.wins/(double)closed : 0.0,
+                r.gross_loss>0 ? r.gross_win/r.gross_loss : 0.0);
+    std::printf("balance      %.2f -> %.2f  (net %+.2f, max drawdown %.2f, Sharpe %.2f)\n",
+                balance0, r.balance, r.balance - balance0, r.max_dd, ea::tools::sharpe(r));
+    std::printf("level        final %d, highest planned %d\n", EA_CurrentLevel(h), r.max_level);
+    std::printf("legs by level");
+    for(int32_t l=1;l<=25;++l) if(r.by_level[l]) std::printf("  L%d:%lld", l, (long long)r.by_level[l]);
+    std::printf("\n");
+    if(trades) std::fclose(trades);
+    if(equity) std::fclose(equity);
+    EA_DestroyContext(h);
+    return 0;
+}
@@ -0,0 +1,14 @@
+# Runs a tool and compares the files it writes with expected copies.
+#   cmake -DCMD="prog;args..." -DOUTPUTS="out;expected;..." -P check_output.cmake
+execute_process(COMMAND ${CMD} RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+  message(FATAL_ERROR "${CMD} exited with ${rc}")
+endif()
+while(OUTPUTS)
+  list(POP_FRONT OUTPUTS out expected)
+  execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${out} ${expected} RESULT_VARIABLE diff)
+  if(NOT diff EQUAL 0)
+    file(READ ${out} got)
+    message(FATAL_ERROR "${out} differs from ${expected}:\n${got}")
+  endif()
+endwhile()
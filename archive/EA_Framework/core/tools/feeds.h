@@ -0,0 +1,56 @@
+#pragma once
+// Synthetic feeds shared by the host tools, the bench drivers and the test
+// suite: the golden candle that gets a plan out of a default context, and
+// the deterministic random walk behind every synthetic tick series.
+#include <stdint.h>
+#include "ea_api.h"
+#include "ticks.h"
+
+namespace ea { namespace tools {
+
+// The golden candle at digits=2: a 200.0 range candle opening at t (spread
+// 0.2), closed by a tick in the next minute. Offsets from (t, base), bid side.
+struct GoldenTick { int64_t dt; double bid; };
+inline constexpr GoldenTick kGoldenTicks[5] = { {0, 0.0}, {5, 0.0}, {10, 200.0}, {20, 190.0}, {60, 195.0} };
+inline constexpr double kGoldenSpread = 0.2;
+
+// Feeds the golden candle, its close moved to base+close_off; with default
+// settings it emits a plan. True if it did.
+inline bool golden_candle(int32_t h, int64_t t, double base = 60000.0, double close_off = 190.0){
+    int32_t a = 0, r = 0;
+    for(const GoldenTick& g : kGoldenTicks){
+        const double bid = base + (g.dt==20 ? close_off : g.bid);
+        EA_OnTick(h, bid, bid+kGoldenSpread, t+g.dt, 0, &a); r |= a;
+    }
+    return r==EA_PLAN_ORDERS;
+}
+
+// golden_candle at t, then t moves two minutes on for the next one.
+inline bool signal(int32_t h, int64_t& t, double base = 60000.0){
+    const bool planned = golden_candle(h, t, base);
+    t += 120;
+    return planned;
+}
+
+// LCG walk: each step moves px by a uniform whole number of ticks in [-amp, amp].
+// s is the state after the step, free for callers to draw more from.
+struct Walk {
+    uint32_t s;
+    double   px;
+    double step(int32_t amp = 200, double tick = 0.02){
+        s = s*1103515245u + 12345u;
+        return px += ((int32_t)((s>>16)%(uint32_t)(2*amp+1)) - amp) * tick;
+    }
+};
+
+// tick_profile's walk: 40 ticks per minute around 60000, digits=2.
+inline void synth(TickColumns& out, int64_t n){
+    Walk w{12345, 60000.0};
+    out.reserve((size_t)n);
+    for(int64_t i=0;i<n;++i){
+        const double px = w.step();
+        out.push(1700000000 + i/40, px, px + 0.20);
+    }
+}
+
+}} // namespace ea::tools
@@ -0,0 +1,181 @@
+#pragma once
+// The broker side of a tick replay, shared by the backtest tool and the
+// GoldenCandleEA library's RunBacktest: it plays the plans the core emits the
+// way GoldenCandleEA.mq4 does live (backtest.cpp documents the model) and
+// keeps the account report. Portable: no tick store, no threads.
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+#include <vector>
+#include "ea_api.h"
+#include "ticks.h"
+
+namespace ea { namespace tools {
+
+struct Leg {
+    int32_t ticket, qual, level;
+    double  entry, sl, tp, lots;
+    double  fill;           // 0 while pending
+    int64_t placed_time, fill_time;
+};
+
+struct Report {
+    int64_t plans = 0, placed = 0, filled = 0, expired = 0, tp = 0, sl = 0;
+    int64_t wins = 0, losses = 0;
+    double  gross_win = 0, gross_loss = 0;
+    double  balance = 0, peak = 0, max_dd = 0;   // equity drawdown, marked to Bid
+    int32_t max_level = 1;
+    int64_t by_level[26] = {};                   // legs closed, by level at plan time
+    double  start = 0;                           // balance before the first tick
+    int64_t first_day = INT64_MIN, last_day = 0; // UTC days of the first and last tick
+    std::vector<std::pair<int64_t, double>> closes;   // (day, balance after its last close)
+};
+
+// The broker side of the replay. Ticks on which no leg can change (no fill,
+// exit or expiry) only move the equity, so with an empty book or between
+// broker events they go to the core in runs through EA_OnTicks; the tick of
+// an event is stepped on its own, events first.
+struct Replay {
+    int32_t h, digits;
+    double  point, contract;
+    int64_t expiry;
+    FILE    *trades, *equity;
+    Report  r;
+    std::vector<Leg> book;
+    int32_t ticket = 0;
+
+    // contract: account currency per lot per price unit; expiry: seconds a
+    // leg may stay pending (0 = never); trades/equity: CSV rows, or null.
+    Replay(int32_t h_, int32_t digits_, double point_, double contract_, int64_t expiry_,
+           FILE* trades_ = nullptr, FILE* equity_ = nullptr)
+        : h(h_), digits(digits_), point(point_), contract(contract_), expiry(expiry_),
+          trades(trades_), equity(equity_) {}
+
+    bool event(int64_t t, double bid, double ask) const {
+        for(const Leg& g : book){
+            if(g.fill==0){ if((expiry>0 && t - g.placed_time >= expiry) || ask >= g.entry) return true; }
+            else if(bid <= g.sl || bid >= g.tp) return true;
+        }
+        return false;
+    }
+
+    void mark(double floating){
+        const double eq = r.balance + floating;
+        r.peak = std::max(r.peak, eq);
+        r.max_dd = std::max(r.max_dd, r.peak - eq);
+    }
+
+    void plan(int64_t t, double ask){
+        ++r.plans;
+        const int32_t lv = EA_CurrentLevel(h);
+        r.max_level = std::max(r.max_level, lv);
+        const int32_t legs = EA_PlanOrdersCount(h);
+        for(int32_t i=0;i<legs;++i){
+            Leg g{};
+            if(EA_PlanOrderGet(h, i, &g.entry, &g.sl, &g.tp, &g.lots, &g.qual)!=1) continue;
+            if(g.entry <= ask) g.entry = ask + 10*point;
+            g.ticket = ++ticket; g.level = lv; g.placed_time = t;
+            book.push_back(g);
+            ++r.placed;
+            EA_OnOrderPlaced(h, g.ticket, g.qual);
+        }
+    }
+
+    // One tick with broker events: fills, exits and expiries, then the core.
+    // False when the core fails the tick.
+    bool step(int64_t t, double bid, double ask){
+        double floating = 0;
+        for(size_t i=0;i<book.size();){
+            Leg& g = book[i];
+            if(g.fill==0){
+                if(expiry>0 && t - g.placed_time >= expiry){
+                    ++r.expired;
+                    EA_OnOrderClosed(h, g.ticket, 0, 0);
+                    book[i] = book.back(); book.pop_back();
+                    continue;
+                }
+                if(ask < g.entry){ ++i; continue; }
+                g.fill = ask; g.fill_time = t; ++r.filled;
+                EA_OnOrderFilled(h, g.ticket, ask);
+            }
+            const bool by_sl = bid <= g.sl, by_tp = !by_sl && bid >= g.tp;
+            if(!by_sl && !by_tp){ floating += (bid - g.fill)*g.lots*contract; ++i; continue; }
+            const double profit = (bid - g.fill)*g.lots*contract;
+            r.balance += profit;
+            if(profit>=0){ ++r.wins; r.gross_win += profit; } else { ++r.losses; r.gross_loss -= profit; }
+            r.tp += by_tp; r.sl += by_sl;
+            if(r.closes.empty() || r.closes.back().first != t/86400) r.closes.push_back({t/86400, r.balance});
+            else r.closes.back().second = r.balance;
+            ++r.by_level[std::clamp(g.level, 1, 25)];
+            EA_OnOrderClosed(h, g.ticket, by_tp, by_sl);
+            EA_ReportClosedProfit(h, profit);
+            if(trades) std::fprintf(trades, "%d,%d,%d,%lld,%.*f,%lld,%.*f,%s,%.2f\n", g.ticket, g.qual, g.level,
+                                    (long long)g.fill_time, digits, g.fill, (long long)t, digits, bid,
+                                    by_tp ? "tp" : "sl", profit);
+            if(equity) std::fprintf(equity, "%lld,%.2f\n", (long long)t, r.balance);
+            book[i] = book.back(); book.pop_back();
+        }
+        mark(floating);
+
+        int32_t action = 0;
+        if(EA_OnTick(h, bid, ask, t, book.empty() ? 0 : 1, &action) < 0) return false;
+        if(action==EA_PLAN_ORDERS) plan(t, ask);
+        return true;
+    }
+
+    // Replays s; false when the core fails a call, the report then stops at
+    // the tick before.
+    bool run(const TickSpan& s){
+        static constexpr int64_t kRun = 1<<30;   // EA_OnTicks takes an int32_t count
+        if(s.n==0) return true;
+        if(r.first_day==INT64_MIN) r.first_day = s.time[0]/86400;
+        r.last_day = s.time[s.n-1]/86400;
+        int64_t k = 0;
+        while(k < s.n){
+            int32_t action = 0;
+            if(book.empty()){
+                const int32_t got = EA_OnTicks(h, s.time+k, s.bid+k, s.ask+k, (int32_t)std::min(s.n-k, kRun), 0, &action);
+                if(got < 0) return false;
+                k += got;
+                if(action==EA_PLAN_ORDERS) plan(s.time[k-1], s.ask[k-1]);
+                continue;
+            }
+            int64_t j = k;
+            for(; j<s.n && j-k<kRun && !event(s.time[j], s.bid[j], s.ask[j]); ++j){
+                double floating = 0;
+                for(const Leg& g : book) if(g.fill!=0) floating += (s.bid[j] - g.fill)*g.lots*contract;
+                mark(floating);
+            }
+            if(j>k && EA_OnTicks(h, s.time+k, s.bid+k, s.ask+k, (int32_t)(j-k), 1, &action) < 0) return false;
+            if(j<s.n && j-k<kRun){
+                if(!step(s.time[j], s.bid[j], s.ask[j])) return false;
+                ++j;
+            }
+            k = j;
+        }
+        return true;
+    }
+};
+
+// Annualized Sharpe ratio of daily balance returns from the first to the last
+// replayed day, days without a close counting as flat; 365 days a year, as
+// the core's symbols trade every day. 0 with fewer than two days or no spread.
+inline double sharpe(const Report& r){
+    if(r.first_day==INT64_MIN || r.last_day <= r.first_day) return 0;
+    double prev = r.start, sum = 0, sum2 = 0;
+    size_t c = 0;
+    const int64_t n = r.last_day - r.first_day + 1;
+    for(int64_t d=r.first_day; d<=r.last_day; ++d){
+        double b = prev;
+        while(c < r.closes.size() && r.closes[c].first <= d) b = r.closes[c++].second;
+        const double ret = prev!=0 ? (b - prev)/prev : 0;
+        sum += ret; sum2 += ret*ret;
+        prev = b;
+    }
+    const double mean = sum/(double)n, var = (sum2 - sum*mean)/(double)(n-1);
+    return var>0 ? mean/std::sqrt(var)*std::sqrt(365.0) : 0;
+}
+
+}} // namespace ea::tools
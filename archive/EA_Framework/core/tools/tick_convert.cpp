@@ -0,0 +1,100 @@
+// Converts a terminal tick export (CSV, see ticks.h) into the columnar tick
+// store of tickstore.h, which backtest maps instead of parsing. Chunks are
+// packed (delta/varint) unless --raw is given. Packing quantizes prices to
+// --point, so a packed conversion fails, and leaves no output, when any price
+// is off that grid (5-digit quotes under the 2 / 0.01 default) unless
+// --requantize accepts the rounding, or too large to count in points (2^53).
+//
+//   tick_convert <ticks.csv | -> <out.ticks> [options]
+//
+//   --symbol S             recorded in the header (default "")
+//   --digits D --point P   symbol scale recorded in the header (default 2 / 0.01)
+//   --chunk N              ticks per chunk (default 65536)
+//   --raw                  uncompressed chunks, replayed in place
+//   --requantize           packed: round prices off the point grid instead of failing
+//   --synthetic N          ticks of the synthetic walk used with "-" (default 10M)
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include "feeds.h"
+#include "tickstore.h"
+
+namespace {
+
+bool arg(int argc, char** argv, int& i, const char* name, const char*& out){
+    if(std::strcmp(argv[i], name)!=0 || i+1>=argc) return false;
+    out = argv[++i];
+    return true;
+}
+
+}
+
+int main(int argc, char** argv){
+    if(argc<3){
+        std::fprintf(stderr, "usage: tick_convert <ticks.csv|-> <out.ticks> [--symbol S --digits D --point P "
+                             "--chunk N --raw --requantize --synthetic N]\n");
+        return 1;
+    }
+    const char* symbol = "";
+    int32_t digits = 2;
+    double point = 0.01;
+    int64_t chunk = ea::tools::kStoreChunk, synthetic = 10000000;
+    int32_t codec = ea::tools::kStorePacked;
+    bool requantize = false;
+    for(int i=3;i<argc;++i){
+        const char* v = nullptr;
+        if(arg(argc, argv, i, "--symbol", v))         symbol = v;
+        else if(arg(argc, argv, i, "--digits", v))    digits = std::atoi(v);
+        else if(arg(argc, argv, i, "--point", v))     point = std::atof(v);
+        else if(arg(argc, argv, i, "--chunk", v))     chunk = std::atoll(v);
+        else if(arg(argc, argv, i, "--synthetic", v)) synthetic = std::atoll(v);
+        else if(std::strcmp(argv[i], "--raw")==0)     codec = ea::tools::kStoreRaw;
+        else if(std::strcmp(argv[i], "--requantize")==0) requantize = true;
+        else { std::fprintf(stderr, "unknown option %s\n", argv[i]); return 1; }
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    ea::tools::StoreWriter w;
+    if(!w.open(argv[2], symbol, digits, point, chunk, codec)){ std::fprintf(stderr, "cannot write %s\n", argv[2]); return 1; }
+    // CSV lines go straight into the writer: memory stays at one chunk
+    if(std::strcmp(argv[1], "-")==0){
+        ea::tools::TickColumns ticks;
+        ea::tools::synth(ticks, synthetic);
+        const size_t n = ticks.time.size();
+        for(size_t i=0;i<n;++i) w.push(ticks.time[i], ticks.bid[i], ticks.ask[i]);
+    }
+    else if(!ea::tools::read_csv(argv[1], [&](int64_t t, double bid, double ask){ w.push(t, bid, ask); })){
+        std::fprintf(stderr, "cannot read %s\n", argv[1]);
+        w.close();
+        std::remove(argv[2]);
+        return 1;
+    }
+    if(!w.close()){
+        if(w.unpackable())
+            std::fprintf(stderr, "%lld prices are beyond 2^53 points at digits %d; use --raw\n",
+                         (long long)w.unpackable(), digits);
+        else std::fprintf(stderr, "write failed: %s\n", argv[2]);
+        std::remove(argv[2]);
+        return 1;
+    }
+    if(w.requantized() && !requantize){
+        std::fprintf(stderr, "%lld prices are off the %g point grid (digits %d); give the symbol's --digits/--point, "
+                             "or --raw, or --requantize to round them\n", (long long)w.requantized(), point, digits);
+        std::remove(argv[2]);
+        return 1;
+    }
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    const ea::tools::StoreHeader& h = w.header();
+    std::printf("%lld ticks in %lld %s chunks of %u, %lld..%lld  (%.2f s)\n", (long long)h.ticks, (long long)h.chunks,
+                codec==ea::tools::kStorePacked ? "packed" : "raw", h.chunk_ticks, (long long)h.min_time,
+                (long long)h.max_time, s);
+    std::printf("%lld bytes, %.2f per tick (%.1fx smaller than raw columns)\n", (long long)w.bytes(),
+                h.ticks ? (double)w.bytes()/(double)h.ticks : 0.0, w.bytes() ? 24.0*(double)h.ticks/(double)w.bytes() : 0.0);
+    if(w.requantized())
+        std::printf("%lld prices were off the %g point grid and read back rounded to it\n",
+                    (long long)w.requantized(), point);
+    return 0;
+}
@@ -0,0 +1,161 @@
+#pragma once
+// Tick input for the host tools: columns (time, bid, ask) from a CSV file or
+// the synthetic walk (feeds.h). The CSV reader streams the file
+// through a fixed buffer and parses it by hand (no sscanf/strtod), so loading
+// keeps up with the replay and a converter never holds the file in memory.
+#include <stdint.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace ea { namespace tools {
+
+struct TickColumns {
+    std::vector<int64_t> time;     // epoch seconds
+    std::vector<double>  bid, ask;
+    void reserve(size_t n){ time.reserve(n); bid.reserve(n); ask.reserve(n); }
+    void push(int64_t t, double b, double a){ time.push_back(t); bid.push_back(b); ask.push_back(a); }
+};
+
+// Columns of a run of ticks, not owned.
+struct TickSpan {
+    const int64_t* time;
+    const double*  bid;
+    const double*  ask;
+    int64_t        n;
+};
+
+// Tick rows [begin, end).
+struct TickRange {
+    int64_t begin, end;
+};
+
+// Rows of the ticks with from <= time < to (times in order).
+inline TickRange time_range(const TickColumns& c, int64_t from, int64_t to){
+    const int64_t b = std::lower_bound(c.time.begin(), c.time.end(), from) - c.time.begin();
+    return { b, std::lower_bound(c.time.begin() + b, c.time.end(), to) - c.time.begin() };
+}
+
+inline TickSpan span_of(const TickColumns& c, TickRange r){
+    return { c.time.data() + r.begin, c.bid.data() + r.begin, c.ask.data() + r.begin, r.end - r.begin };
+}
+
+namespace detail {
+
+// Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's algorithm).
+inline int64_t days_from_civil(int64_t y, int64_t m, int64_t d){
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y-399) / 400;
+    const int64_t yoe = y - era*400;
+    const int64_t doy = (153*(m + (m > 2 ? -3 : 9)) + 2)/5 + d-1;
+    const int64_t doe = yoe*365 + yoe/4 - yoe/100 + doy;
+    return era*146097 + doe - 719468;
+}
+
+inline bool digits(const char*& p, const char* e, int64_t& v, int32_t& n){
+    v = 0; n = 0;
+    while(p<e && *p>='0' && *p<='9'){ v = v*10 + (*p++ - '0'); ++n; }
+    return n>0;
+}
+
+// [-]int[.frac], at most 18 significant digits. m / 10^k is correctly
+// rounded (both exact doubles), as strtod would give.
+inline bool price(const char*& p, const char* e, double& out){
+    static const double kPow10[19] = { 1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,1e12,1e13,1e14,1e15,1e16,1e17,1e18 };
+    const bool neg = p<e && *p=='-';
+    if(neg) ++p;
+    int64_t m = 0; int32_t n = 0, k = 0;
+    if(!digits(p, e, m, n)) return false;
+    if(p<e && *p=='.'){
+        ++p;
+        while(p<e && *p>='0' && *p<='9'){ m = m*10 + (*p++ - '0'); ++k; }
+    }
+    if(n + k > 18) return false;
+    out = (double)m / kPow10[k];
+    if(neg) out = -out;
+    return true;
+}
+
+inline bool expect(const char*& p, const char* e, char c){
+    if(p<e && *p==c){ ++p; return true; }
+    return false;
+}
+
+// Epoch seconds or YYYY.MM.DD HH:MM:SS[.mmm] (or YYYY-MM-DD ...); with
+// dates_only the time of day may be left out (midnight).
+inline bool timestamp(const char*& p, const char* e, int64_t& t, bool dates_only = false){
+    int64_t a; int32_t n;
+    if(!digits(p, e, a, n)) return false;
+    if(n==4 && p<e && (*p=='.' || *p=='-')){
+        const char sep = *p;
+        int64_t mo, d, hh = 0, mi = 0, ss = 0;
+        if(!(expect(p, e, sep) && digits(p, e, mo, n) && expect(p, e, sep) && digits(p, e, d, n))) return false;
+        if(!(dates_only && p==e) &&
+           !(expect(p, e, ' ') && digits(p, e, hh, n) && expect(p, e, ':') && digits(p, e, mi, n) &&
+             expect(p, e, ':') && digits(p, e, ss, n))) return false;
+        if(expect(p, e, '.')){ int64_t ms; if(!digits(p, e, ms, n)) return false; }
+        t = days_from_civil(a, mo, d)*86400 + hh*3600 + mi*60 + ss;
+    } else t = a;
+    return true;
+}
+
+// One line, without its terminator.
+inline bool parse_line(const char* p, const char* e, int64_t& t, double& bid, double& ask){
+    return timestamp(p, e, t) && expect(p, e, ',') && price(p, e, bid) && expect(p, e, ',') && price(p, e, ask);
+}
+
+} // namespace detail
+
+// A command-line time: epoch seconds, "YYYY.MM.DD" or "YYYY.MM.DD HH:MM:SS",
+// with dots or dashes between the date fields.
+inline bool parse_time(const char* s, int64_t& t){
+    const char* e = s;
+    while(*e) ++e;
+    return detail::timestamp(s, e, t, true) && s==e;
+}
+
+// Calls on_tick(t, bid, ask) for every parseable line of path, in file
+// order. The file goes through a fixed 64 KiB buffer; a line longer than that
+// is skipped like any other that does not parse. False when the file cannot
+// be opened or a read fails.
+template<class F>
+inline bool read_csv(const char* path, F&& on_tick){
+    FILE* f = std::fopen(path, "rb");
+    if(!f) return false;
+    char buf[1<<16];
+    auto line = [&](const char* p, const char* eol){
+        const char* e = (eol>p && eol[-1]=='\r') ? eol-1 : eol;
+        int64_t t; double bid, ask;
+        if(detail::parse_line(p, e, t, bid, ask)) on_tick(t, bid, ask);
+    };
+    size_t have = 0;
+    bool skip = false;                 // in the tail of an over-long line
+    for(;;){
+        const size_t k = std::fread(buf + have, 1, sizeof(buf) - have, f);
+        const char* p = buf;
+        const char* const end = buf + have + k;
+        while(const char* eol = (const char*)std::memchr(p, '\n', (size_t)(end - p))){
+            if(!skip) line(p, eol);
+            skip = false;
+            p = eol + 1;
+        }
+        if(k==0){                      // end of file: a last line without '\n'
+            if(!skip && p<end) line(p, end);
+            break;
+        }
+        have = (size_t)(end - p);
+        if(have==sizeof(buf)){ have = 0; skip = true; }
+        else std::memmove(buf, p, have);
+    }
+    const bool ok = !std::ferror(f);
+    std::fclose(f);
+    return ok;
+}
+
+// Appends every parseable line of path; false when the file cannot be read.
+inline bool load_csv(const char* path, TickColumns& out){
+    return read_csv(path, [&](int64_t t, double bid, double ask){ out.push(t, bid, ask); });
+}
+
+}} // namespace ea::tools
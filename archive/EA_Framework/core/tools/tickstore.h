@@ -0,0 +1,555 @@
+#pragma once
+// Columnar tick store: a tick history as fixed-size chunks of three columns
+// (time, bid, ask) that a reader maps instead of parsing. The layout is
+// little-endian and every section starts on a 64-byte boundary:
+//
+//   StoreHeader                       128 bytes
+//   chunk 0   (per header.codec)
+//   chunk 1   ...
+//   StoreChunk[chunks]                directory, at header.directory
+//
+// Raw chunks (kStoreRaw) are time int64[n] | bid double[n] | ask double[n],
+// each column padded to the alignment, and are handed out in place with no
+// copy. Packed chunks (kStorePacked) hold the same columns in about a sixth
+// of the space: a PackedChunk header, then three byte streams of LEB128
+// varints: time deltas from the chunk's first tick (directory min_time), then
+// zigzag deltas of the bid in points and of the spread in points, both
+// starting from 0. Prices are quantized to the header's point; terminal
+// exports already are, and decode back to the same doubles. Every chunk
+// decodes on its own, so ChunkStream decodes several at once.
+//
+// Chunks hold header.chunk_ticks ticks except the last, so tick row r is in
+// chunk r / chunk_ticks. Each directory entry carries its chunk's first and
+// last tick time: the directory is a sparse time index with a fence every
+// chunk_ticks rows, and a time range opens with a binary search over it plus
+// one over a single chunk's time column. Ticks are in time order, as the
+// terminal exports them. Written by tick_convert; read by backtest and by
+// the GoldenCandleEA library's RunBacktest (mapped on POSIX and Windows).
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+#include "ticks.h"
+
+namespace ea { namespace tools {
+
+static constexpr char     kStoreMagic[8] = { 'E','A','T','I','C','K','S','\0' };
+static constexpr uint32_t kStoreVersion  = 1;
+static constexpr int64_t  kStoreChunk    = 1<<16;   // default ticks per chunk
+static constexpr int64_t  kStoreAlign    = 64;
+
+enum StoreCodec : int32_t {
+    kStoreRaw    = 0,
+    kStorePacked = 1,
+};
+
+struct StoreHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t chunk_ticks;
+    char     symbol[32];
+    int32_t  digits;
+    int32_t  codec;                // StoreCodec
+    double   point;
+    int64_t  ticks;
+    int64_t  chunks;
+    int64_t  directory;            // file offset of StoreChunk[chunks]
+    int64_t  min_time, max_time;   // 0 when empty
+    uint8_t  reserved[24];
+};
+static_assert(sizeof(StoreHeader)==128 && sizeof(StoreHeader) % kStoreAlign==0, "StoreHeader is part of the file format");
+
+struct StoreChunk {
+    int64_t offset;                // of the time column / the PackedChunk
+    int64_t count;
+    int64_t min_time, max_time;    // first and last tick
+};
+static_assert(sizeof(StoreChunk)==32, "StoreChunk is part of the file format");
+
+struct PackedChunk {
+    uint32_t time_bytes, bid_bytes, spread_bytes;
+    uint32_t reserved;
+};
+static_assert(sizeof(PackedChunk)==16, "PackedChunk is part of the file format");
+
+// Bytes of one column of n ticks, padded to the alignment.
+inline int64_t store_column_bytes(int64_t n){
+    return (n*8 + kStoreAlign-1) / kStoreAlign * kStoreAlign;
+}
+
+namespace detail {
+
+inline void put_varint(std::vector<uint8_t>& out, uint64_t v){
+    while(v >= 0x80){ out.push_back((uint8_t)(v | 0x80)); v >>= 7; }
+    out.push_back((uint8_t)v);
+}
+
+inline bool get_varint(const uint8_t*& p, const uint8_t* e, uint64_t& v){
+    if(p<e && *p<0x80){ v = *p++; return true; }   // most deltas
+    uint64_t x = 0;
+    for(int32_t s=0; p<e && s<64; s+=7){
+        const uint8_t b = *p++;
+        x |= (uint64_t)(b & 0x7f) << s;
+        if(b < 0x80){ v = x; return true; }
+    }
+    return false;
+}
+
+inline uint64_t zigzag(int64_t v){ return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+inline int64_t unzigzag(uint64_t v){ return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+} // namespace detail
+
+// Prices <-> integer points. With a decimal point (10^-digits) a price is
+// points / 10^digits, correctly rounded: the double the CSV parser gives for
+// the same text, so packed terminal exports decode bit for bit. That holds
+// while |points| < 2^53, where points are exact doubles; fits() tells, and
+// points() must not be called beyond it (llround overflows past 2^63).
+struct PriceScale {
+    static constexpr double kMaxPoints = 9007199254740992.0;   // 2^53
+    double k;
+    bool   decimal;
+
+    PriceScale(int32_t digits, double point){
+        const double p10 = (digits>=0 && digits<=18) ? std::pow(10.0, digits) : 0.0;
+        decimal = p10>0 && std::fabs(point*p10 - 1.0) < 1e-9;
+        k = decimal ? p10 : point;
+    }
+    bool    fits(double px) const { return std::fabs(decimal ? px*k : px/k) < kMaxPoints; }   // false for NaN
+    int64_t points(double px) const { return std::llround(decimal ? px*k : px/k); }
+    double  price(int64_t pts) const { return decimal ? (double)pts / k : (double)pts * k; }
+};
+
+// Streams ticks into a store: push() buffers one chunk and writes it out when
+// full; close() writes the last chunk, the directory and the final header.
+class StoreWriter {
+public:
+    StoreWriter() = default;
+    StoreWriter(const StoreWriter&) = delete;
+    StoreWriter& operator=(const StoreWriter&) = delete;
+    ~StoreWriter(){ if(f_) std::fclose(f_); }
+
+    bool open(const char* path, const char* symbol, int32_t digits, double point,
+              int64_t chunk_ticks = kStoreChunk, int32_t codec = kStoreRaw){
+        if(f_ || chunk_ticks<=0 || chunk_ticks>UINT32_MAX || (codec!=kStoreRaw && codec!=kStorePacked)) return false;
+        // Packed: a positive point, digits PriceScale can scale by exactly
+        if(codec==kStorePacked && !(point>0 && digits>=0 && digits<=18)) return false;
+        f_ = std::fopen(path, "wb");
+        if(!f_) return false;
+        std::memset(&hdr_, 0, sizeof(hdr_));
+        dir_.clear();
+        requantized_ = unpackable_ = 0;
+        std::memcpy(hdr_.magic, kStoreMagic, sizeof(kStoreMagic));
+        hdr_.version = kStoreVersion;
+        hdr_.chunk_ticks = (uint32_t)chunk_ticks;
+        std::snprintf(hdr_.symbol, sizeof(hdr_.symbol), "%s", symbol ? symbol : "");
+        hdr_.digits = digits;
+        hdr_.codec = codec;
+        hdr_.point = point;
+        buf_.reserve((size_t)chunk_ticks);
+        ok_ = std::fwrite(&hdr_, sizeof(hdr_), 1, f_)==1;   // rewritten by close()
+        pos_ = sizeof(hdr_);
+        return ok_;
+    }
+
+    void push(int64_t t, double bid, double ask){
+        buf_.push(t, bid, ask);
+        if((int64_t)buf_.time.size() >= (int64_t)hdr_.chunk_ticks) flush();
+    }
+
+    // False if any write failed; the file is then incomplete.
+    bool close(){
+        if(!f_) return false;
+        flush();
+        hdr_.chunks = (int64_t)dir_.size();
+        hdr_.directory = pos_;
+        if(!dir_.empty()){ hdr_.min_time = dir_.front().min_time; hdr_.max_time = dir_.back().max_time; }
+        ok_ = ok_ && (dir_.empty() || std::fwrite(dir_.data(), sizeof(StoreChunk), dir_.size(), f_)==dir_.size());
+        ok_ = ok_ && std::fseek(f_, 0, SEEK_SET)==0 && std::fwrite(&hdr_, sizeof(hdr_), 1, f_)==1;
+        ok_ = std::fclose(f_)==0 && ok_;
+        f_ = nullptr;
+        return ok_;
+    }
+
+    const StoreHeader& header() const { return hdr_; }
+    int64_t bytes() const { return pos_ + (int64_t)(dir_.size()*sizeof(StoreChunk)); }   // after close()
+    // Packed prices that were not on the point grid (they read back rounded).
+    int64_t requantized() const { return requantized_; }
+    // Packed prices at 2^53 points or beyond (or not finite): they cannot be
+    // stored, and close() fails.
+    int64_t unpackable() const { return unpackable_; }
+
+private:
+    void put(const void* p, size_t n){
+        ok_ = ok_ && std::fwrite(p, 1, n, f_)==n;
+        pos_ += (int64_t)n;
+    }
+
+    void align(){
+        static const char kZero[kStoreAlign] = {};
+        put(kZero, (size_t)((kStoreAlign - pos_ % kStoreAlign) % kStoreAlign));
+    }
+
+    void pack(int64_t n){
+        const PriceScale sc(hdr_.digits, hdr_.point);
+        time_.clear(); bid_.clear(); spread_.clear();
+        int64_t t0 = buf_.time[0], b0 = 0, s0 = 0;
+        for(int64_t i=0;i<n;++i){
+            const double bid = buf_.bid[i], ask = buf_.ask[i];
+            const int64_t misfits = !sc.fits(bid) + !sc.fits(ask);
+            const bool fit = misfits==0;
+            if(!fit){ unpackable_ += misfits; ok_ = false; }
+            const int64_t b = fit ? sc.points(bid) : b0, s = fit ? sc.points(ask) - b : s0;
+            if(fit) requantized_ += (sc.price(b)!=bid) + (sc.price(b + s)!=ask);
+            detail::put_varint(time_, (uint64_t)(buf_.time[i] - t0));
+            detail::put_varint(bid_, detail::zigzag(b - b0));
+            detail::put_varint(spread_, detail::zigzag(s - s0));
+            t0 = buf_.time[i]; b0 = b; s0 = s;
+        }
+        const PackedChunk pc{ (uint32_t)time_.size(), (uint32_t)bid_.size(), (uint32_t)spread_.size(), 0 };
+        put(&pc, sizeof(pc));
+        put(time_.data(), time_.size());
+        put(bid_.data(), bid_.size());
+        put(spread_.data(), spread_.size());
+        align();
+    }
+
+    void flush(){
+        const int64_t n = (int64_t)buf_.time.size();
+        if(n==0) return;
+        // The header and the padded chunks keep pos_ aligned
+        dir_.push_back({ pos_, n, buf_.time.front(), buf_.time.back() });
+        if(hdr_.codec==kStorePacked) pack(n);
+        else {
+            put(buf_.time.data(), (size_t)n*8); align();
+            put(buf_.bid.data(), (size_t)n*8);  align();
+            put(buf_.ask.data(), (size_t)n*8);  align();
+        }
+        hdr_.ticks += n;
+        buf_.time.clear(); buf_.bid.clear(); buf_.ask.clear();
+    }
+
+    FILE*                   f_ = nullptr;
+    StoreHeader             hdr_{};
+    TickColumns             buf_;
+    std::vector<uint8_t>    time_, bid_, spread_;
+    std::vector<StoreChunk> dir_;
+    int64_t                 pos_ = 0, requantized_ = 0, unpackable_ = 0;
+    bool                    ok_ = false;
+};
+
+// Maps a store read-only. open() checks the header and that every chunk lies
+// in the file; a packed chunk's varints are checked as it is decoded.
+class StoreReader {
+public:
+    StoreReader() = default;
+    StoreReader(const StoreReader&) = delete;
+    StoreReader& operator=(const StoreReader&) = delete;
+    ~StoreReader(){ close(); }
+
+    bool open(const char* path){
+        close();
+#ifdef _WIN32
+        const HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                     FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if(f==INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER st;
+        if(!GetFileSizeEx(f, &st) || st.QuadPart < (LONGLONG)sizeof(StoreHeader)){ CloseHandle(f); return false; }
+        size_ = (size_t)st.QuadPart;
+        const HANDLE m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(f);
+        void* p = m ? MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if(m) CloseHandle(m);              // the view keeps the mapping
+        if(!p){ size_ = 0; return false; }
+        base_ = (const char*)p;
+#else
+        const int fd = ::open(path, O_RDONLY);
+        if(fd<0) return false;
+        struct stat st;
+        if(::fstat(fd, &st)!=0 || st.st_size < (off_t)sizeof(StoreHeader)){ ::close(fd); return false; }
+        size_ = (size_t)st.st_size;
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if(p==MAP_FAILED){ size_ = 0; return false; }
+        base_ = (const char*)p;
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+#endif
+        if(!valid()){ close(); return false; }
+        return true;
+    }
+
+    void close(){
+#ifdef _WIN32
+        if(base_) UnmapViewOfFile(base_);
+#else
+        if(base_) ::munmap((void*)base_, size_);
+#endif
+        base_ = nullptr; size_ = 0;
+    }
+
+    const StoreHeader& header() const { return *(const StoreHeader*)base_; }
+    int64_t chunks() const { return header().chunks; }
+    bool packed() const { return header().codec==kStorePacked; }
+    const StoreChunk& chunk_info(int64_t i) const { return directory()[i]; }
+
+    // A raw chunk in place, valid until close().
+    TickSpan chunk(int64_t i) const {
+        const StoreChunk& c = directory()[i];
+        const char* p = base_ + c.offset;
+        const int64_t col = store_column_bytes(c.count);
+        return { (const int64_t*)p, (const double*)(p + col), (const double*)(p + 2*col), c.count };
+    }
+
+    // Chunk i into out (replaced), either codec; false on a corrupt chunk.
+    // With time_only the price columns are left empty.
+    bool decode(int64_t i, TickColumns& out, bool time_only = false) const {
+        const StoreChunk& c = directory()[i];
+        const size_t n = (size_t)c.count;
+        out.time.resize(n);
+        out.bid.resize(time_only ? 0 : n);
+        out.ask.resize(time_only ? 0 : n);
+        if(!packed()){
+            const TickSpan s = chunk(i);
+            std::memcpy(out.time.data(), s.time, n*8);
+            if(!time_only){ std::memcpy(out.bid.data(), s.bid, n*8); std::memcpy(out.ask.data(), s.ask, n*8); }
+            return true;
+        }
+        PackedChunk pc;
+        std::memcpy(&pc, base_ + c.offset, sizeof(pc));
+        const uint8_t* tp = (const uint8_t*)base_ + c.offset + sizeof(pc);
+        const uint8_t *te = tp + pc.time_bytes, *bp = te, *be = bp + pc.bid_bytes, *sp = be, *se = sp + pc.spread_bytes;
+        int64_t t = c.min_time;
+        for(size_t k=0;k<n;++k){
+            uint64_t d;
+            if(!detail::get_varint(tp, te, d)) return false;
+            out.time[k] = t += (int64_t)d;
+        }
+        if(tp!=te || out.time[n-1]!=c.max_time) return false;
+        if(time_only) return true;
+        const PriceScale sc(header().digits, header().point);
+        int64_t b = 0, s = 0;
+        for(size_t k=0;k<n;++k){
+            uint64_t db, ds;
+            if(!detail::get_varint(bp, be, db) || !detail::get_varint(sp, se, ds)) return false;
+            b += detail::unzigzag(db); s += detail::unzigzag(ds);
+            out.bid[k] = sc.price(b);
+            out.ask[k] = sc.price(b + s);
+        }
+        return bp==be && sp==se;
+    }
+
+    // First row with time >= t (ticks() when none). A packed store decodes
+    // the time column of the one chunk it lands in.
+    int64_t seek(int64_t t) const {
+        const StoreChunk* d = directory();
+        const int64_t c = std::partition_point(d, d + chunks(), [t](const StoreChunk& x){ return x.max_time < t; }) - d;
+        if(c==chunks()) return header().ticks;
+        const int64_t base = c*header().chunk_ticks;
+        if(!packed()){
+            const TickSpan s = chunk(c);
+            return base + (std::lower_bound(s.time, s.time + s.n, t) - s.time);
+        }
+        TickColumns cols;
+        if(!decode(c, cols, true)) return base;   // corrupt: the chunk fails again when replayed
+        return base + (std::lower_bound(cols.time.begin(), cols.time.end(), t) - cols.time.begin());
+    }
+
+    // Rows of the ticks with from <= time < to.
+    TickRange range(int64_t from, int64_t to) const {
+        const int64_t b = seek(from);
+        return { b, std::max(b, seek(to)) };
+    }
+
+    TickRange all() const { return { 0, header().ticks }; }
+
+    // Chunks [first, last) holding the rows of r.
+    void chunks_of(TickRange r, int64_t& first, int64_t& last) const {
+        const int64_t ct = header().chunk_ticks;
+        first = r.begin/ct;
+        last = r.end > r.begin ? (r.end-1)/ct + 1 : first;
+    }
+
+    // The rows of r in s, chunk c's columns (n = 0 when they do not meet).
+    TickSpan clip(int64_t c, const TickSpan& s, TickRange r) const {
+        const int64_t base = c*header().chunk_ticks;
+        const int64_t b = std::clamp(r.begin - base, (int64_t)0, s.n);
+        const int64_t e = std::clamp(r.end - base, b, s.n);
+        return { s.time + b, s.bid + b, s.ask + b, e - b };
+    }
+
+    // Calls f(TickSpan) for the rows of r, one span per chunk, in order: raw
+    // chunks in place, packed ones decoded on this thread (see ChunkStream).
+    // False when a chunk is corrupt; the spans before it were delivered.
+    template<class F>
+    bool for_each(TickRange r, F&& f) const {
+        int64_t c0, c1;
+        chunks_of(r, c0, c1);
+        TickColumns cols;
+        for(int64_t c=c0;c<c1;++c){
+            if(!packed()){ f(clip(c, chunk(c), r)); continue; }
+            if(!decode(c, cols)) return false;
+            f(clip(c, { cols.time.data(), cols.bid.data(), cols.ask.data(), (int64_t)cols.time.size() }, r));
+        }
+        return true;
+    }
+
+    // r cut into at most parts consecutive ranges of about equal size, each
+    // cut on a chunk boundary, so parallel workers never share a chunk.
+    std::vector<TickRange> split(TickRange r, int32_t parts) const {
+        std::vector<TickRange> out;
+        const int64_t ct = header().chunk_ticks;
+        int64_t b = r.begin;
+        for(int32_t i=1;i<=parts && b<r.end;++i){
+            int64_t e = r.end;
+            if(i<parts){
+                const int64_t at = r.begin + (r.end - r.begin)*i/parts;
+                e = std::min(r.end, (at + ct/2)/ct*ct);
+            }
+            if(e > b){ out.push_back({ b, e }); b = e; }
+        }
+        return out;
+    }
+
+private:
+    const StoreChunk* directory() const { return (const StoreChunk*)(base_ + header().directory); }
+
+    int64_t chunk_bytes(const StoreChunk& c) const {
+        if(!packed()) return 3*store_column_bytes(c.count);
+        if(c.offset > (int64_t)size_ - (int64_t)sizeof(PackedChunk)) return INT64_MAX/2;
+        PackedChunk pc;
+        std::memcpy(&pc, base_ + c.offset, sizeof(pc));
+        return (int64_t)sizeof(pc) + pc.time_bytes + pc.bid_bytes + pc.spread_bytes;
+    }
+
+    bool valid() const {
+        const StoreHeader& h = header();
+        const int64_t size = (int64_t)size_;
+        if(std::memcmp(h.magic, kStoreMagic, sizeof(kStoreMagic))!=0 || h.version!=kStoreVersion) return false;
+        if((h.codec!=kStoreRaw && h.codec!=kStorePacked) || (h.codec==kStorePacked && !(h.point>0))) return false;
+        if(h.chunks<0 || h.directory<(int64_t)sizeof(StoreHeader) || h.directory % 8
+           || h.chunks > (size - h.directory) / (int64_t)sizeof(StoreChunk)) return false;
+        int64_t ticks = 0;
+        for(int64_t i=0;i<h.chunks;++i){
+            const StoreChunk& c = directory()[i];
+            if(c.count<=0 || c.count>(int64_t)h.chunk_ticks || (i+1<h.chunks && c.count!=(int64_t)h.chunk_ticks)
+               || c.min_time>c.max_time || (i>0 && c.min_time<directory()[i-1].max_time) || c.offset<(int64_t)sizeof(StoreHeader)
+               || c.offset % kStoreAlign || c.offset > size - chunk_bytes(c)) return false;
+            ticks += c.count;
+        }
+        return ticks==h.ticks;
+    }
+
+    const char* base_ = nullptr;
+    size_t      size_ = 0;
+};
+
+// The spans of a range, in order, with the chunks decoded by worker threads
+// up to depth chunks ahead of the consumer. The queue is a ring of depth
+// decode buffers: a worker claims the next chunk once its slot's previous
+// chunk has been released, so memory stays at depth chunks however far the
+// workers could run ahead. Raw stores are handed out in place, no threads.
+// With threads = 0 next() decodes inline. The reader must outlive the stream.
+class ChunkStream {
+public:
+    ChunkStream(const StoreReader& r, TickRange range, int32_t threads, int32_t depth = 0)
+        : r_(r), range_(range){
+        r.chunks_of(range, claim_, end_);
+        next_ = released_ = claim_;
+        if(!r.packed()) threads = 0;
+        depth_ = std::max<int32_t>(depth>0 ? depth : 2*threads, 1);
+        slots_.resize((size_t)depth_);
+        for(int32_t i=0;i<threads;++i) threads_.emplace_back([this]{ work(); });
+    }
+
+    ~ChunkStream(){
+        { std::lock_guard<std::mutex> lk(m_); stop_ = true; }
+        free_.notify_all();
+        for(std::thread& t : threads_) t.join();
+    }
+
+    ChunkStream(const ChunkStream&) = delete;
+    ChunkStream& operator=(const ChunkStream&) = delete;
+
+    // The next span, valid until the following call; false at the end of the
+    // range or on a corrupt chunk (failed() tells which).
+    bool next(TickSpan& out){
+        if(failed_ || next_>=end_) return false;
+        const int64_t c = next_++;
+        if(!r_.packed()){ out = r_.clip(c, r_.chunk(c), range_); return true; }
+        Slot& s = slots_[(size_t)(c % depth_)];
+        if(threads_.empty()) s.ok = r_.decode(c, s.cols);
+        else {
+            std::unique_lock<std::mutex> lk(m_);
+            released_ = c;                                   // the previous span is done with
+            free_.notify_all();
+            ready_.wait(lk, [&]{ return s.chunk==c; });
+        }
+        if(!s.ok){ failed_ = true; return false; }
+        out = r_.clip(c, { s.cols.time.data(), s.cols.bid.data(), s.cols.ask.data(), (int64_t)s.cols.time.size() }, range_);
+        return true;
+    }
+
+    bool failed() const { return failed_; }
+
+private:
+    struct Slot {
+        TickColumns cols;
+        int64_t     chunk = -1;   // decoded chunk, set when done
+        bool        ok = false;
+    };
+
+    void work(){
+        TickColumns cols;
+        std::unique_lock<std::mutex> lk(m_);
+        for(;;){
+            free_.wait(lk, [&]{ return stop_ || claim_>=end_ || claim_ < released_ + depth_; });
+            if(stop_ || claim_>=end_) return;
+            const int64_t c = claim_++;
+            Slot& s = slots_[(size_t)(c % depth_)];
+            lk.unlock();
+            const bool ok = r_.decode(c, cols);
+            lk.lock();
+            std::swap(s.cols, cols);
+            s.ok = ok; s.chunk = c;
+            ready_.notify_all();
+        }
+    }
+
+    const StoreReader&       r_;
+    TickRange                range_;
+    int64_t                  claim_ = 0, end_ = 0, next_ = 0, released_ = 0;
+    int32_t                  depth_ = 1;
+    bool                     stop_ = false, failed_ = false;
+    std::vector<Slot>        slots_;
+    std::mutex               m_;
+    std::condition_variable  ready_, free_;
+    std::vector<std::thread> threads_;
+};
+
+// True when path starts with the store magic (else it is taken as CSV).
+inline bool is_store(const char* path){
+    FILE* f = std::fopen(path, "rb");
+    if(!f) return false;
+    char m[sizeof(kStoreMagic)];
+    const bool yes = std::fread(m, 1, sizeof(m), f)==sizeof(m) && std::memcmp(m, kStoreMagic, sizeof(m))==0;
+    std::fclose(f);
+    return yes;
+}
+
+}} // namespace ea::tools
@@ -6,11 +6,23 @@
 
 struct BacktestParams {
     double sharpeRatioTarget;
-    char startDate[11]; // YYYY-MM-DD
-    char endDate[11];   // YYYY-MM-DD
+    char startDate[11]; // YYYY-MM-DD, first day replayed (UTC); empty = from the first tick
+    char endDate[11];   // YYYY-MM-DD, last day replayed (UTC); empty = to the last tick
+    char tickFile[260]; // tick export, "time,bid,ask" lines (EA_Framework/core/tools/ticks.h),
+                        // or a tick store written by tick_convert (tools/tickstore.h)
+    int digits;         // symbol scale; 0 = the store's, else 2 / 0.01
+    double point;
+    double initialBalance; // 0 = 10000
     // Add more as needed
 };
 
-void RunBacktest(const BacktestParams* params);
+// Replays tickFile through the EA core with the broker model of the core's
+// backtest tool (tools/replay.h) and prints the report. A tick store opens
+// the date range with a binary search over its chunk index and decodes only
+// the chunks in it; a CSV export is loaded whole. The report includes
+// whether the Sharpe ratio of daily returns reaches sharpeRatioTarget.
+// Returns 1 when it does, 0 when it does not, -1 when the backtest cannot run
+// or the core fails during it.
+int RunBacktest(const BacktestParams* params);
 
 #endif // GOLDENCANDLEEA_BACKTEST_H
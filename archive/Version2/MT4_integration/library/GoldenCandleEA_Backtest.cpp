@@ -1,8 +1,91 @@
 // GoldenCandleEA_Backtest.cpp
+// Built with EA_Framework/core/include and tools on the include
+// path, linked against the EA core.
 #include "GoldenCandleEA_Backtest.h"
 #include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <thread>
+#include "ea_api.h"
+#include "replay.h"
+#include "tickstore.h"
 
-void RunBacktest(const BacktestParams* params) {
-    // TODO: Implement backtest logic (stub)
-    printf("Running backtest from %s to %s, Sharpe Ratio Target: %.2f\n", params->startDate, params->endDate, params->sharpeRatioTarget);
+// The fixed-size fields may fill their array without a terminator
+static void CopyField(char* out, const char* in, size_t n) {
+    memcpy(out, in, n);
+    out[n] = '\0';
+}
+
+int RunBacktest(const BacktestParams* params) {
+    if(!params) return -1;
+    char startDate[sizeof(params->startDate)+1], endDate[sizeof(params->endDate)+1], tickFile[sizeof(params->tickFile)+1];
+    CopyField(startDate, params->startDate, sizeof(params->startDate));
+    CopyField(endDate, params->endDate, sizeof(params->endDate));
+    CopyField(tickFile, params->tickFile, sizeof(params->tickFile));
+
+    // [startDate 00:00, endDate + 1 day): both days are replayed in full
+    int64_t from = INT64_MIN, to = INT64_MAX;
+    if((startDate[0] && !ea::tools::parse_time(startDate, from)) || (endDate[0] && !ea::tools::parse_time(endDate, to))) {
+        printf("Backtest: bad date range %s to %s (expected YYYY-MM-DD)\n", startDate, endDate);
+        return -1;
+    }
+    if(endDate[0]) to += 86400;
+
+    // A tick store opens the range through its chunk index, a CSV export is
+    // loaded whole
+    ea::tools::TickColumns ticks;
+    ea::tools::StoreReader store;
+    const bool stored = ea::tools::is_store(tickFile);
+    if(stored ? !store.open(tickFile) : !ea::tools::load_csv(tickFile, ticks)) {
+        printf("Backtest: cannot read %s\n", tickFile);
+        return -1;
+    }
+    const ea::tools::TickRange range = stored ? store.range(from, to) : ea::tools::time_range(ticks, from, to);
+    if(range.end == range.begin) {
+        printf("Backtest: no ticks in %s from %s to %s\n", tickFile, startDate, endDate);
+        return -1;
+    }
+
+    const int digits = params->digits > 0 ? params->digits : stored ? store.header().digits : 2;
+    const double point = params->digits > 0 ? params->point : stored ? store.header().point : 0.01;
+    const double balance = params->initialBalance > 0 ? params->initialBalance : 10000.0;
+    const int32_t h = EA_CreateContext();
+    if(h <= 0 || EA_Init(h, "BACKTEST", 1, digits, point) != 1) {
+        printf("Backtest: core init failed\n");
+        if(h > 0) EA_DestroyContext(h);
+        return -1;
+    }
+    ea::tools::Replay rp(h, digits, point, 1.0, 0);
+    rp.r.balance = rp.r.peak = rp.r.start = balance;
+    bool ok = true, corrupt = false;
+    if(stored) {
+        // Packed chunks decoded ahead on the spare cores, as the backtest tool does
+        const int32_t threads = (int32_t)std::clamp<unsigned>(std::thread::hardware_concurrency(), 2, 5) - 1;
+        ea::tools::ChunkStream stream(store, range, threads);
+        ea::tools::TickSpan s;
+        while(stream.next(s)) if(!(ok = rp.run(s))) break;
+        corrupt = stream.failed();
+    }
+    else ok = rp.run(ea::tools::span_of(ticks, range));
+    EA_DestroyContext(h);
+    if(corrupt) {
+        printf("Backtest: corrupt chunk in %s\n", tickFile);
+        return -1;
+    }
+    if(!ok) {
+        printf("Backtest: core error during the replay\n");
+        return -1;
+    }
+
+    const ea::tools::Report& r = rp.r;
+    const int64_t closed = r.wins + r.losses;
+    const double sharpe = ea::tools::sharpe(r);
+    printf("Backtest %s to %s: %lld ticks, %lld plans, %lld trades closed (%lld TP, %lld SL), win rate %.1f%%\n",
+           startDate[0] ? startDate : "start", endDate[0] ? endDate : "end", (long long)(range.end - range.begin),
+           (long long)r.plans, (long long)closed, (long long)r.tp, (long long)r.sl,
+           closed ? 100.0*(double)r.wins/(double)closed : 0.0);
+    printf("Balance %.2f -> %.2f, max drawdown %.2f, Sharpe Ratio %.2f (target %.2f: %s)\n",
+           balance, r.balance, r.max_dd, sharpe, params->sharpeRatioTarget,
+           sharpe >= params->sharpeRatioTarget ? "met" : "missed");
+    return sharpe >= params->sharpeRatioTarget ? 1 : 0;
 }
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <vector>
+#include <string>
 #include "MarketTypes.h"
+#include "PositionManagerCore.h"
 
 namespace GoldenCandle {
 
@@ -26,6 +28,18 @@ struct RiskState {
     double marginLevel;
     bool isRiskExceeded;
     std::string lastError;
+    double tripPrice;        // bid at which the first limit trips
+    int tripLimit;           // RiskLimit behind tripPrice
+};
+
+//+------------------------------------------------------------------+
+//| Limit behind the trip price                                      |
+//+------------------------------------------------------------------+
+enum RiskLimit {
+    RISK_LIMIT_NONE = 0,
+    RISK_LIMIT_DRAWDOWN,
+    RISK_LIMIT_DAILY_LOSS,
+    RISK_LIMIT_MARGIN
 };
 
 //+------------------------------------------------------------------+
@@ -45,6 +59,23 @@ private:
     long m_lastCheckTime;
     std::vector<double> m_profitHistory;
     
+    // Account snapshot (UpdateState)
+    double m_balance;
+    double m_equity;
+    double m_margin;
+    std::string m_lastError;
+    
+    // Open positions folded into equity(bid) = balance + m_equityConst + m_equitySlope * bid
+    double m_equityConst;
+    double m_equitySlope;
+    
+    // Trip threshold: limits hold while m_tripSide * (bid - m_tripPrice) >= 0
+    double m_tripPrice;
+    double m_tripSide;
+    int m_tripLimit;
+    
+    void RecomputeTripPrice();
+    
     // Internal validation
     bool ValidateMarginLevel(double equity, double margin) const;
     bool ValidateDrawdown(double equity) const;
@@ -70,6 +101,15 @@ public:
     void UpdateState(double balance, double equity, double margin);
     void OnNewDay(double balance);
     
+    // Position changes: refolds the open positions and moves the trip price
+    void OnPositionsChanged(const std::vector<PositionInfo>& positions,
+                           const MarketData& market);
+    
+    // Per-tick check: one comparison against the precomputed trip price
+    bool CheckTick(double bid) const { return m_tripSide * (bid - m_tripPrice) >= 0.0; }
+    double GetTripPrice() const { return m_tripPrice; }
+    int GetTripLimit() const { return m_tripLimit; }
+    
     // Risk metrics
     double GetCurrentDrawdown(double equity) const;
     double GetDailyProfit(double currentBalance) const;
@@ -0,0 +1,255 @@
+#include "RiskManagementCore.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace GoldenCandle {
+
+namespace {
+    // MT4 order types (OP_BUY / OP_SELL); pending orders carry no exposure
+    const int kOrderBuy  = 0;
+    const int kOrderSell = 1;
+    const double kInf = std::numeric_limits<double>::infinity();
+}
+
+RiskManagementCore::RiskManagementCore()
+    : m_initialized(false),
+      m_initialBalance(0.0),
+      m_dailyStartBalance(0.0),
+      m_worstDrawdown(0.0),
+      m_lastCheckTime(0),
+      m_balance(0.0),
+      m_equity(0.0),
+      m_margin(0.0),
+      m_equityConst(0.0),
+      m_equitySlope(0.0),
+      m_tripPrice(-kInf),
+      m_tripSide(1.0),
+      m_tripLimit(RISK_LIMIT_NONE) {
+    // Defaults match the MQL4 risk manager
+    m_settings.maxDrawdown = 20.0;
+    m_settings.dailyLossLimit = 500.0;
+    m_settings.marginMinimum = 200.0;
+    m_settings.maxSpreadPoints = 50;
+    m_settings.riskPercent = 1.0;
+}
+
+RiskManagementCore::~RiskManagementCore() {
+    // Cleanup if needed
+}
+
+bool RiskManagementCore::Initialize(const CoreConfig& config) {
+    (void)config;   // limits come from SetSettings
+    if (m_initialized) return true;
+
+    m_profitHistory.clear();
+    m_lastError.clear();
+    RecomputeTripPrice();
+
+    m_initialized = true;
+    return true;
+}
+
+void RiskManagementCore::SetSettings(const RiskSettings& settings) {
+    m_settings = settings;
+    RecomputeTripPrice();
+}
+
+//+------------------------------------------------------------------+
+//| Trip price                                                         |
+//|                                                                    |
+//| With the open positions fixed, equity is linear in bid:            |
+//|   buy:  (bid - open) * lots * tickValue / tickSize                 |
+//|   sell: (open - bid - spread) * lots * tickValue / tickSize        |
+//| and the drawdown and margin limits are floors on equity (drawdown  |
+//| from the initial balance, margin level on the used margin), so the |
+//| higher floor maps to one bid price; beyond it a limit is broken.   |
+//| The daily loss limit is on balance, which no price move changes:   |
+//| once broken it fails the check at any bid. This runs only when     |
+//| positions, balance or settings change, never per tick.             |
+//+------------------------------------------------------------------+
+void RiskManagementCore::RecomputeTripPrice() {
+    m_tripSide = 1.0;
+    if (!ValidateDailyLoss(m_balance)) {
+        m_tripLimit = RISK_LIMIT_DAILY_LOSS;
+        m_tripPrice = kInf;
+        return;
+    }
+
+    double floor = -kInf;
+    m_tripLimit = RISK_LIMIT_NONE;
+    if (m_initialBalance > 0) {
+        floor = m_initialBalance * (1.0 - m_settings.maxDrawdown / 100.0);
+        m_tripLimit = RISK_LIMIT_DRAWDOWN;
+    }
+    if (m_margin > 0) {
+        double marginFloor = m_margin * m_settings.marginMinimum / 100.0;
+        if (marginFloor > floor) {
+            floor = marginFloor;
+            m_tripLimit = RISK_LIMIT_MARGIN;
+        }
+    }
+
+    const double base = m_balance + m_equityConst;
+    if (m_tripLimit == RISK_LIMIT_NONE || m_equitySlope == 0.0) {
+        // Equity doesn't move with price: the limits either hold or don't
+        m_tripPrice = (m_tripLimit == RISK_LIMIT_NONE || base >= floor) ? -kInf : kInf;
+        return;
+    }
+
+    // Net long: safe at or above the price; net short: at or below it
+    m_tripPrice = (floor - base) / m_equitySlope;
+    m_tripSide = m_equitySlope > 0 ? 1.0 : -1.0;
+}
+
+void RiskManagementCore::OnPositionsChanged(const std::vector<PositionInfo>& positions,
+                                            const MarketData& market) {
+    const double valuePerPrice = market.tickSize > 0 ? market.tickValue / market.tickSize : 0.0;
+    const double spread = market.spread * market.point;
+
+    double slope = 0.0, constant = 0.0;
+    for (const auto& pos : positions) {
+        if (pos.isComplete) continue;
+        const double k = pos.lots * valuePerPrice;
+        if (pos.type == kOrderBuy) {
+            slope += k;
+            constant -= k * pos.openPrice;
+        } else if (pos.type == kOrderSell) {
+            slope -= k;
+            constant += k * (pos.openPrice - spread);
+        }
+    }
+    m_equitySlope = slope;
+    m_equityConst = constant;
+    RecomputeTripPrice();
+}
+
+//+------------------------------------------------------------------+
+//| Validation                                                         |
+//+------------------------------------------------------------------+
+bool RiskManagementCore::ValidateMarginLevel(double equity, double margin) const {
+    if (margin <= 0) return true;   // nothing used
+    return equity / margin * 100.0 >= m_settings.marginMinimum;
+}
+
+bool RiskManagementCore::ValidateDrawdown(double equity) const {
+    return GetCurrentDrawdown(equity) <= m_settings.maxDrawdown;
+}
+
+bool RiskManagementCore::ValidateDailyLoss(double currentBalance) const {
+    return GetDailyProfit(currentBalance) >= -std::fabs(m_settings.dailyLossLimit);
+}
+
+bool RiskManagementCore::ValidateSpread(const MarketData& market) const {
+    return market.spread <= m_settings.maxSpreadPoints;
+}
+
+bool RiskManagementCore::ValidateNewPosition(const EntryPoint& entry,
+                                             const MarketData& market) {
+    if (!m_initialized || entry.lots <= 0 || entry.stopLoss <= 0) return false;
+    if (market.tickSize <= 0) {
+        m_lastError = "Invalid tick size";
+        return false;
+    }
+
+    // Loss if the stop is hit
+    double distance = std::fabs(entry.price - entry.stopLoss);
+    double potentialLoss = (distance / market.tickSize) * market.tickValue * entry.lots;
+
+    if (GetDailyProfit(m_balance) - potentialLoss < -std::fabs(m_settings.dailyLossLimit)) {
+        m_lastError = "Position would exceed daily loss limit";
+        return false;
+    }
+    if (GetCurrentDrawdown(m_equity - potentialLoss) > m_settings.maxDrawdown) {
+        m_lastError = "Position would exceed maximum drawdown";
+        return false;
+    }
+    return true;
+}
+
+bool RiskManagementCore::ValidateAccountState(double balance, double equity,
+                                              double margin) {
+    if (!m_initialized) return false;
+
+    UpdateState(balance, equity, margin);
+    if (!ValidateMarginLevel(equity, margin)) {
+        m_lastError = "Margin level below minimum";
+        return false;
+    }
+    if (!ValidateDrawdown(equity)) {
+        m_lastError = "Maximum drawdown exceeded";
+        return false;
+    }
+    if (!ValidateDailyLoss(balance)) {
+        m_lastError = "Daily loss limit exceeded";
+        return false;
+    }
+    return true;
+}
+
+bool RiskManagementCore::ValidateTradeConditions(const MarketData& market) {
+    if (!m_initialized) return false;
+
+    if (!ValidateSpread(market)) {
+        m_lastError = "Spread too wide";
+        return false;
+    }
+    if (!market.tradeAllowed) {
+        m_lastError = "Trading not allowed";
+        return false;
+    }
+    return true;
+}
+
+//+------------------------------------------------------------------+
+//| Tracking                                                           |
+//+------------------------------------------------------------------+
+void RiskManagementCore::UpdateState(double balance, double equity, double margin) {
+    if (m_initialBalance <= 0) m_initialBalance = balance;
+    if (m_dailyStartBalance <= 0) m_dailyStartBalance = balance;
+
+    m_equity = equity;
+    m_worstDrawdown = std::max(m_worstDrawdown, GetCurrentDrawdown(equity));
+
+    // Balance/margin only move on fills and closes: refresh the trip price then
+    if (balance != m_balance || margin != m_margin) {
+        m_balance = balance;
+        m_margin = margin;
+        RecomputeTripPrice();
+    }
+}
+
+void RiskManagementCore::OnNewDay(double balance) {
+    if (m_dailyStartBalance > 0) {
+        m_profitHistory.push_back(balance - m_dailyStartBalance);
+    }
+    m_dailyStartBalance = balance;
+    RecomputeTripPrice();
+}
+
+//+------------------------------------------------------------------+
+//| Metrics                                                            |
+//+------------------------------------------------------------------+
+double RiskManagementCore::GetCurrentDrawdown(double equity) const {
+    if (m_initialBalance <= 0) return 0.0;
+    return (m_initialBalance - equity) / m_initialBalance * 100.0;
+}
+
+double RiskManagementCore::GetDailyProfit(double currentBalance) const {
+    return currentBalance - m_dailyStartBalance;
+}
+
+void RiskManagementCore::GetCurrentState(RiskState& state) const {
+    state.currentDrawdown = GetCurrentDrawdown(m_equity);
+    state.maxDrawdown = m_worstDrawdown;
+    state.dailyProfit = GetDailyProfit(m_balance);
+    state.marginLevel = m_margin > 0 ? m_equity / m_margin * 100.0 : 0.0;
+    state.isRiskExceeded = !ValidateMarginLevel(m_equity, m_margin) ||
+                           !ValidateDrawdown(m_equity) ||
+                           !ValidateDailyLoss(m_balance);
+    state.lastError = m_lastError;
+    state.tripPrice = m_tripPrice;
+    state.tripLimit = m_tripLimit;
+}
+
+} // namespace GoldenCandle
@@ -0,0 +1,110 @@
+// CheckTick(bid) against ValidateAccountState over random accounts and
+// positions: the precomputed trip price must give the same verdict as the
+// full check on equity evaluated position by position at that bid, both at
+// random bids and straddling the trip price itself.
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include "RiskManagementCore.h"
+
+using namespace GoldenCandle;
+
+namespace {
+
+int g_fail = 0;
+#define CHECK(cond) do { if(!(cond)){ std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); ++g_fail; } } while(0)
+
+struct Rng {
+    uint32_t s;
+    double uniform(double lo, double hi){
+        s = s*1103515245u + 12345u;
+        return lo + (hi-lo)*(double)(s>>8)/(double)(1u<<24);
+    }
+};
+
+// Open P&L the way MT4 marks it: buys close at bid, sells at ask
+double equity_at(double balance, const std::vector<PositionInfo>& positions,
+                 const MarketData& m, double bid){
+    const double ask = bid + m.spread*m.point;
+    double eq = balance;
+    for(const PositionInfo& p : positions){
+        if(p.isComplete) continue;
+        const double move = p.type==0 ? bid - p.openPrice : p.openPrice - ask;
+        eq += move/m.tickSize*m.tickValue*p.lots;
+    }
+    return eq;
+}
+
+}
+
+int main(){
+    Rng rng{20240601};
+    CoreConfig config = {};
+    int tripped = 0, held = 0, daily = 0, boundary[RISK_LIMIT_MARGIN+1] = {};
+    for(int trial=0; trial<2000; ++trial){
+        RiskManagementCore risk;
+        risk.Initialize(config);
+        RiskSettings rs;
+        rs.maxDrawdown = rng.uniform(5, 40);
+        rs.dailyLossLimit = rng.uniform(100, 2000);
+        rs.marginMinimum = rng.uniform(50, 400);
+        rs.maxSpreadPoints = 50;
+        rs.riskPercent = 1.0;
+        risk.SetSettings(rs);
+
+        MarketData m = {};
+        m.point = 0.01; m.digits = 2; m.tickSize = 0.01; m.tickValue = 0.01;
+        m.spread = (int)rng.uniform(0, 40);
+
+        const double initial = 10000.0;
+        risk.UpdateState(initial, initial, 0.0);           // initial and day-start balance
+        const double balance = initial + rng.uniform(-2500, 1500);
+        const double margin = rng.uniform(0, 1) < 0.2 ? 0.0 : rng.uniform(100, 6000);
+
+        std::vector<PositionInfo> positions((size_t)rng.uniform(0, 5));
+        for(PositionInfo& p : positions){
+            p = PositionInfo{};
+            p.type = rng.uniform(0, 1) < 0.6 ? 0 : 1;
+            p.lots = rng.uniform(0.01, 0.5);
+            p.openPrice = rng.uniform(59000, 61000);
+            p.isComplete = rng.uniform(0, 1) < 0.1;
+        }
+        risk.OnPositionsChanged(positions, m);
+
+        for(int k=0; k<20; ++k){
+            const double bid = rng.uniform(56000, 64000);
+            const double eq = equity_at(balance, positions, m, bid);
+            const bool full = risk.ValidateAccountState(balance, eq, margin);
+            const bool fast = risk.CheckTick(bid);
+            CHECK(full==fast);
+            if(full!=fast){
+                std::printf("  trial %d bid %.2f equity %.2f balance %.2f margin %.2f trip %.4f limit %d\n",
+                            trial, bid, eq, balance, margin, risk.GetTripPrice(), risk.GetTripLimit());
+                break;
+            }
+            (full ? held : tripped) += 1;
+            daily += risk.GetTripLimit()==RISK_LIMIT_DAILY_LOSS;
+        }
+
+        // At the limit: the trip price itself holds (the validators accept
+        // equity equal to a floor), and a hair past it on either side both
+        // checks agree. 1e-6 in price moves equity by at least 1e-8, well
+        // over its rounding.
+        const double trip = risk.GetTripPrice();
+        if(!std::isfinite(trip)) continue;
+        CHECK(risk.CheckTick(trip));
+        for(double d : { -1e-6, 1e-6 }){
+            const double bid = trip + d;
+            const bool full = risk.ValidateAccountState(balance, equity_at(balance, positions, m, bid), margin);
+            CHECK(full==risk.CheckTick(bid));
+        }
+        ++boundary[risk.GetTripLimit()];
+    }
+    // Both verdicts, the balance-only limit and both equity floors were exercised
+    CHECK(held>1000 && tripped>1000 && daily>1000);
+    CHECK(boundary[RISK_LIMIT_DRAWDOWN]>100 && boundary[RISK_LIMIT_MARGIN]>100);
+    if(g_fail){ std::printf("%d check(s) failed\n", g_fail); return 1; }
+    std::printf("risk_trip: ok (%d held, %d tripped)\n", held, tripped);
+    return 0;
+}